@@ -0,0 +1,72 @@
+/**
+ * Class        Bench
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the micro-benchmark harness declared in Bench.h
+ */
+#include "Bench.h"
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+/**
+ * Returns the value at fraction q (0..1) of the sorted samples,
+ * interpolating linearly between neighbouring ranks
+ */
+static double percentile(const std::vector<double> &sorted, double q)
+{
+  double pos = q * (sorted.size() - 1);
+  size_t lo = (size_t)pos;
+  size_t hi = std::min(lo + 1, sorted.size() - 1);
+  return sorted[lo] + (pos - lo) * (sorted[hi] - sorted[lo]);
+}
+
+BenchResult Bench::run(const char *name, BenchOp op, uint32_t nOps)
+{
+  using Clock = std::chrono::steady_clock;
+  std::vector<double> samples;
+  samples.reserve(_nReps);
+
+  for (uint32_t r = 0; r < _nWarmup + _nReps; r++)
+  {
+    auto t0 = Clock::now();
+    for (uint32_t i = 0; i < nOps; i++) op();
+    auto t1 = Clock::now();
+    if (r >= _nWarmup)
+    {
+      samples.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count() / nOps);
+    }
+  }
+  std::sort(samples.begin(), samples.end());
+
+  BenchResult r;
+  r.name   = name;
+  r.nOps   = nOps;
+  r.nReps  = _nReps;
+  r.median = percentile(samples, 0.50);
+  r.p10    = percentile(samples, 0.10);
+  r.p90    = percentile(samples, 0.90);
+  r.p99    = percentile(samples, 0.99);
+  r.min    = samples.front();
+  r.max    = samples.back();
+  return r;
+}
+
+void Bench::printHeader(FILE *out)
+{
+  fprintf(out, "%-28s %9s %9s %9s %9s %9s %9s   [ns/op]\n",
+          "benchmark", "median", "p10", "p90", "p99", "min", "max");
+}
+
+void Bench::printText(FILE *out, const BenchResult &r)
+{
+  fprintf(out, "%-28s %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f\n",
+          r.name, r.median, r.p10, r.p90, r.p99, r.min, r.max);
+}
+
+void Bench::printJson(FILE *out, const BenchResult &r, bool isLast)
+{
+  fprintf(out, R"(  { "name": "%s", "unit": "ns/op", "ops": %u, "reps": %u, "median": %.2f, "p10": %.2f, "p90": %.2f, "p99": %.2f, "min": %.2f, "max": %.2f }%s
+)", r.name, r.nOps, r.nReps, r.median, r.p10, r.p90, r.p99, r.min, r.max, isLast ? "" : ",");
+}
@@ -0,0 +1,49 @@
+/**
+ * Class        Bench
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Minimal micro-benchmark harness for the host. A benchmark is a
+ *              function executing one operation. It is called in batches of
+ *              nOps operations, each batch is timed with the steady clock and
+ *              the time per operation is collected over nReps batches after a
+ *              few warmup batches. The results are reported as median, min, max
+ *              and the 10th, 90th and 99th percentile in ns per operation.
+ *
+ * Remarks      The operation must not be optimized away, so let it write its
+ *              result to a volatile or to global state.
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+using BenchOp = void (&)();
+
+using BenchResult = struct benchResult
+{
+  const char *name;
+  uint32_t    nOps;    // operations per batch
+  uint32_t    nReps;   // timed batches
+  double      median;  // ns per operation
+  double      p10;
+  double      p90;
+  double      p99;
+  double      min;
+  double      max;
+};
+
+class Bench
+{
+  public:
+    Bench(uint32_t nWarmup = 5, uint32_t nReps = 51) : _nWarmup(nWarmup), _nReps(nReps) {}
+
+    BenchResult run(const char *name, BenchOp op, uint32_t nOps);
+    static void printHeader(FILE *out);
+    static void printText(FILE *out, const BenchResult &r);
+    static void printJson(FILE *out, const BenchResult &r, bool isLast);
+
+  private:
+    uint32_t _nWarmup;
+    uint32_t _nReps;
+};
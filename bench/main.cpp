@@ -0,0 +1,489 @@
+/**
+ * Program      Host micro-benchmarks for the thermostat hot paths
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Measures on the development host the cost of
+ *              - NTCSensor::readSensor() fed by a fake ADC
+ *              - Thermostat::loop() when idle and when the refresh is due
+ *              - the print functions printParams(), printData(), printSettings()
+ *              - the report of a refresh with all values and with changes only
+ *              - heartbeat()
+ *              - one step of the closed-loop simulation (see sim/Plant.h)
+ *              - one tick of the zone manager with 1, 2, 4 and 8 zones, each
+ *                zone at its own constant temperature
+ *              - the acquisition of 8 channels by the ADC scan
+ *              - a tick of the switch coordinator with 8 pending requests
+ *              - one sample published to 3 subscribed thermostats
+ *              - the fusion of 2, 4 and 8 sensors, one of them an outlier
+ *
+ * Usage        pio run -e native_bench && .pio/build/native_bench/program [options]
+ *                --json        write the results as JSON to stdout
+ *                --reps n      number of timed batches (default 51)
+ *                --filter s    run only benchmarks whose name contains s
+ *                --check-alloc verify that the hot paths do not allocate heap
+ *                              memory at steady state, exit code 1 if they do
+ *                --check-writes count the GPIO writes of the heartbeat and of
+ *                              8 zones, exit code 1 if an output is written 
+ *                              without a change
+ *
+ * Remarks      Serial output is formatted into a buffer and discarded, so the
+ *              print benchmarks measure the formatting cost only.
+ */
+#include <Arduino.h>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include "Bench.h"
+#include "ZoneManager.h"
+#include "Plant.h"
+#include "LoopStats.h"
+#include "HeapTrack.h"
+#include "ChangeReport.h"
+#include "FusedSensor.h"
+#include "PidLaw.h"
+#include "Autotune.h"
+#include "MpcLaw.h"
+#include "WeeklySchedule.h"
+
+#define PIN_THERMOSTAT  GPIO_NUM_4
+#define PIN_HEARTBEAT   LED_BUILTIN
+#define PIN_ADC         GPIO_NUM_34
+
+#define WRITES_MIN_CHANGES  200   // of 8 zones in 1000 ticks, see checkGpioWrites()
+
+extern void heartbeat(IActuator &led, uint8_t nBeats, uint8_t t, uint8_t duty);
+extern void doMenu();
+
+void processData();
+void turnHeatingOn();
+void turnHeatingOff();
+void onSwitch(uint8_t zone, bool on) {}
+
+ParamsNTC  ntc = { 10000, 10000, 2800 };
+ParamsADC  adc = { PIN_ADC, true, 4095, ADC_11db, 3300.0, 3200.0, 130.0 };
+SensorData sensorData;
+NTCSensor  sensor(ntc, adc, sensorData);
+Thermostat thermostat(sensor, processData, turnHeatingOn, turnHeatingOff);
+Plant      plant(plantOilRadiator, 19.0f, 5.0f);
+LoopStats  loopStats;
+ChangeReport report(30);
+
+// Zones at a constant temperature each, built anew for every zone benchmark
+uint8_t   zonePins[] = { 32, 33, 34, 35, 36, 37, 38, 39 };
+ParamsADC zoneAdcs[] =
+{
+  { 32, true, 4095, ADC_11db, 3300.0, 3200.0, 130.0 }, { 33, true, 4095, ADC_11db, 3300.0, 3200.0, 130.0 },
+  { 34, true, 4095, ADC_11db, 3300.0, 3200.0, 130.0 }, { 35, true, 4095, ADC_11db, 3300.0, 3200.0, 130.0 },
+  { 36, true, 4095, ADC_11db, 3300.0, 3200.0, 130.0 }, { 37, true, 4095, ADC_11db, 3300.0, 3200.0, 130.0 },
+  { 38, true, 4095, ADC_11db, 3300.0, 3200.0, 130.0 }, { 39, true, 4095, ADC_11db, 3300.0, 3200.0, 130.0 },
+};
+
+class ZoneRig
+{
+  public:
+    ZoneRig(uint8_t nbrZones) :
+      sensors
+      {
+        { ntc, zoneAdcs[0], data[0] }, { ntc, zoneAdcs[1], data[1] }, { ntc, zoneAdcs[2], data[2] }, { ntc, zoneAdcs[3], data[3] },
+        { ntc, zoneAdcs[4], data[4] }, { ntc, zoneAdcs[5], data[5] }, { ntc, zoneAdcs[6], data[6] }, { ntc, zoneAdcs[7], data[7] },
+      },
+      thermostats
+      {
+        { sensors[0], zoneIdle, zoneIdle, zoneIdle }, { sensors[1], zoneIdle, zoneIdle, zoneIdle },
+        { sensors[2], zoneIdle, zoneIdle, zoneIdle }, { sensors[3], zoneIdle, zoneIdle, zoneIdle },
+        { sensors[4], zoneIdle, zoneIdle, zoneIdle }, { sensors[5], zoneIdle, zoneIdle, zoneIdle },
+        { sensors[6], zoneIdle, zoneIdle, zoneIdle }, { sensors[7], zoneIdle, zoneIdle, zoneIdle },
+      },
+      outputs
+      {
+        { 16, &batch }, { 17, &batch }, { 18, &batch }, { 19, &batch },
+        { 21, &batch }, { 22, &batch }, { 23, &batch }, { 25, &batch },
+      },
+      zones
+      {
+        { "z0", sensors[0], thermostats[0], outputs[0], false }, { "z1", sensors[1], thermostats[1], outputs[1], false },
+        { "z2", sensors[2], thermostats[2], outputs[2], false }, { "z3", sensors[3], thermostats[3], outputs[3], false },
+        { "z4", sensors[4], thermostats[4], outputs[4], false }, { "z5", sensors[5], thermostats[5], outputs[5], false },
+        { "z6", sensors[6], thermostats[6], outputs[6], false }, { "z7", sensors[7], thermostats[7], outputs[7], false },
+      },
+      manager(zones, nbrZones, onSwitch)
+    {}
+
+    SensorData  data[8];
+    NTCSensor   sensors[8];
+    Thermostat  thermostats[8];
+    GpioBatch   batch;
+    GpioOutput  outputs[8];
+    Zone        zones[8];
+    ZoneManager manager;
+};
+GpioOutput led(PIN_HEARTBEAT);
+GpioOutput heater(PIN_THERMOSTAT);
+Zone       cliZones[] = { { "z0", sensor, thermostat, heater, false } };
+SensorPublisher publisher(sensor);
+Thermostat subscribers[] = 
+{
+  { sensor, processData, turnHeatingOn, turnHeatingOff }, { sensor, processData, turnHeatingOn, turnHeatingOff },
+  { sensor, processData, turnHeatingOn, turnHeatingOff },
+};
+
+// Sensor with a fixed temperature, so that the fusion cost is measured alone
+class ConstSensor : public ISensor
+{
+  public:
+    ConstSensor(float t) { _data.tCelsius = t; }
+    void  setup() override {}
+    void  readSensor() override {}
+    float getCelsius() override { return _data.tCelsius; }
+    void  printData() override {}
+    SensorData& getDataReference() override { return _data; }
+  private:
+    SensorData _data;
+};
+
+ConstSensor constSensors[] = { 20.1f, 35.0f, 20.3f, 19.9f, 20.0f, 20.4f, 20.2f, 19.8f };
+FusedInput  fusedInputs[] =
+{
+  { constSensors[0], 1.0f }, { constSensors[1], 1.0f }, { constSensors[2], 2.0f }, { constSensors[3], 1.0f },
+  { constSensors[4], 1.0f }, { constSensors[5], 1.0f }, { constSensors[6], 1.0f }, { constSensors[7], 1.0f },
+};
+SensorData  fusedData;
+FusedSensor fused2(fusedInputs, 2, fusedData);
+FusedSensor fused4(fusedInputs, 4, fusedData);
+FusedSensor fused8(fusedInputs, 8, fusedData);
+
+SwitchCoordinator coordinator(8, 0);
+AdcScan    adcScan(zonePins, 8, ADC_11db);
+ZoneManager zoneManager(cliZones, 1, onSwitch);  // used by the cli
+PidLaw      pidLaws[8];                       // used by the cli
+MpcLaw      mpcLaws[8];                       // used by the cli
+Autotune    autotune;                         // used by the cli
+int8_t      zoneTuned = -1;                   // used by the cli
+SwitchPredictor predictors[8];                // used by the cli
+AdaptiveBand bands[8];                        // used by the cli
+std::optional<ZoneRig> rig;                   // zones of the running zone benchmark
+
+bool heatingIsOn = false;
+volatile float sink;
+
+// Fake ADC sweeping through the codes of a plausible temperature range
+uint16_t fakeAdc(uint8_t pin)
+{
+  static uint16_t code = 1500;
+  code = code < 2500 ? code + 7 : 1500;
+  return code;
+}
+
+// Fake ADC of a room at constant temperature
+uint16_t constAdc(uint8_t pin) { return 2000; }
+
+// Fake ADC of the zone pins 32..39, each at its own constant temperature of 16..23 °C
+uint16_t zoneAdc(uint8_t pin) { return 2347 - 36 * (pin & 7); }
+
+// Fake ADC of the zone pins 32..39, each swinging between 17 and 22 °C with its
+// own period of 30..58 ms, so that the zones cross their limits every few ticks
+uint16_t cyclingAdc(uint8_t pin)
+{
+  uint32_t period = 30 + 4 * (pin & 7);
+  uint32_t t = (hostGetMicros() / 1000) % period;
+  uint32_t n = t < period / 2 ? t : period - t;
+  return 2132 + 179 * n / (period / 2);
+}
+
+uint16_t plantAdc(uint8_t pin) { return ntcAdcCode(plant.getRoom(), ntc, adc); }
+
+void processData()    { sensor.readSensor(); }
+void turnHeatingOn()  { heatingIsOn = true; }
+void turnHeatingOff() { heatingIsOn = false; }
+
+// Benchmarked operations
+void opReadSensor()    { sensor.readSensor(); sink = sensor.getCelsius(); }
+void opLoopIdle()      { hostAdvanceMicros(1000); thermostat.loop(); }
+void opLoopRefresh()   { hostAdvanceMicros(1000); thermostat.loop(); }
+void opPrintParams()   { sensor.printParams(); }
+void opPrintData()     { sensor.printData(); }
+void opPrintSettings() { thermostat.printSettings(); }
+void opReport()        { sensor.readSensor(); report.begin(); sensor.reportParams(report); 
+                         sensor.reportData(report); thermostat.reportSettings(report); }
+void opReportAll()     { report.disable(); opReport(); report.enable(); }
+void opHeartbeat()     { hostAdvanceMicros(1000); heartbeat(led, 1, 1, 5); }
+void opZones()         { hostAdvanceMicros(1000); rig->manager.loop(); }
+void opAdcScan()       { adcScan.start(); adcScan.scan(); }   // the zone cases stop the scan
+void opPublish()       { publisher.publish(); }
+void opFused2()        { fused2.readSensor(); sink = fused2.getCelsius(); }
+void opFused4()        { fused4.readSensor(); sink = fused4.getCelsius(); }
+void opFused8()        { fused8.readSensor(); sink = fused8.getCelsius(); }
+void opFaultCheck()
+{
+  static FaultDetector detector;
+  static uint32_t us = 0;
+  uint16_t code = fakeAdc(0);
+  sink = detector.check(code, 4095, 20.0f + code * 0.001f, us += 1000);
+}
+void opPidControl()
+{
+  static PidLaw pid;
+  static uint32_t us = 0;
+  sink = pid.control(19.0f + (fakeAdc(0) & 63) * 0.01f, 19.5f, us += 10000000);
+}
+void opPredictSwitch()
+{
+  static SwitchPredictor predictor;
+  static uint32_t us = 0;
+  static uint32_t n  = 0;
+  float t = 19.0f + (fakeAdc(0) & 63) * 0.01f;
+  predictor.sample(t, us += 10000000);
+  if ((++n & 63) == 0) predictor.transition(n & 64, t);
+  sink = predictor.getOvershoot() + predictor.getUndershoot();
+}
+void opAdaptiveBand()
+{
+  static AdaptiveBand band;
+  static uint32_t us = 0;
+  static uint32_t n  = 0;
+  float t = 19.0f + (fakeAdc(0) & 63) * 0.01f;
+  band.sample(t, us += 10000000);
+  if ((++n & 63) == 0) band.transition(n & 64, 18.0f, 21.0f);
+  sink = band.getDelta() + band.getBias();
+}
+void opMpcSolve()
+{
+  static MpcLaw mpc;
+  static bool isTrained = false;
+  if (! isTrained)   // identify a first order room with samples of 10 s
+  {
+    float t = 19.0f;
+    uint32_t us = 0;
+    for (uint16_t k = 0; k < 20000; k++)
+    {
+      float u = mpc.control(t, 19.5f, us += 10000000);
+      t += 0.002f * u - 0.0001f * (t - 5.0f);
+    }
+    isTrained = true;
+  }
+  sink = mpc.solve(19.0f + (fakeAdc(0) & 63) * 0.01f, 19.5f);
+}
+void opScheduleTick()   // a minute of the office week per tick, a transition every few hundred ticks
+{
+  static const ScheduleSlot office[] = 
+  { 
+    { SCHEDULE_WORKDAYS, 6, 30, 40, 44 }, { SCHEDULE_WORKDAYS, 18, 0, 32, 36 }, { SCHEDULE_WEEKEND, 0, 0, 32, 36 } 
+  };
+  static WeeklySchedule schedule;
+  static Thermostat th(sensor, zoneIdle, zoneIdle, zoneIdle);
+  if (schedule.getNbrTransitions() == 0)
+  {
+    schedule.setSlots(office, 3);
+    schedule.enable();
+    WeeklySchedule::setClock(0, 0, 0);
+  }
+  hostAdvanceMicros(60000000);
+  sink = schedule.loop(th);
+}
+void opCoordinator()
+{
+  static uint8_t n = 0;
+  for (uint8_t z = 0; z < 8; z++) coordinator.request(z, (float)((z + n) & 7));
+  coordinator.tick(millis());
+  coordinator.release(n++ & 7);
+}
+void opSimTick()       { hostAdvanceMicros(10000); thermostat.loop(); plant.step(0.01f, heatingIsOn ? 1.0f : 0.0f); }
+
+/**
+ * Build the zones of a zone benchmark anew, so that the
+ * decisions and outputs of a case do not carry over to the next
+ */
+void newZones(uint8_t nbrZones, ScanMode mode)
+{
+  FaultParams noStuck = faultParamsNTC;   // the fake ADC has no noise, a constant channel would look stuck
+  noStuck.nStuck = 0;
+  rig.emplace(nbrZones);
+  for (NTCSensor &s : rig->sensors) s.getFaultDetector().setParams(noStuck);
+  if (nbrZones == 8) rig->manager.setAdcScan(adcScan);
+  rig->manager.setup();
+  rig->manager.setScanMode(mode);
+  rig->manager.setSampleInterval(0);
+  rig->manager.setGpioBatch(rig->batch);
+  for (Thermostat &t : rig->thermostats) t.setRefreshInterval(1);
+}
+void newZones1()       { newZones(1, SCAN_ALL); }
+void newZones2()       { newZones(2, SCAN_ALL); }
+void newZones4()       { newZones(4, SCAN_ALL); }
+void newZones8()       { newZones(8, SCAN_ALL); }
+void newZones8RoundRobin() { newZones(8, SCAN_ROUND_ROBIN); }
+void newZones8Dma()    { newZones(8, SCAN_DMA); }
+
+using BenchCase = struct benchCase { const char *name; BenchOp op; uint32_t nOps; uint32_t msRefresh; AnalogReader adc; void (*setup)() = nullptr; };
+
+BenchCase cases[] =
+{
+  { "ntc_read_sensor",         opReadSensor,    1000,  10000, fakeAdc },
+  { "thermostat_loop_idle",    opLoopIdle,      1000, 600000, fakeAdc },
+  { "thermostat_loop_refresh", opLoopRefresh,   1000,      1, fakeAdc },
+  { "print_params",            opPrintParams,    100,  10000, fakeAdc },
+  { "print_data",              opPrintData,      100,  10000, fakeAdc },
+  { "print_settings",          opPrintSettings,  100,  10000, fakeAdc },
+  { "report_all",              opReportAll,      100,  10000, fakeAdc },
+  { "report_changes",          opReport,         100,  10000, constAdc },
+  { "heartbeat",               opHeartbeat,     1000,  10000, fakeAdc },
+  { "sim_tick",                opSimTick,       1000,   1000, plantAdc },
+  { "zones_tick_1",            opZones,         1000,  10000, zoneAdc, newZones1 },
+  { "zones_tick_2",            opZones,         1000,  10000, zoneAdc, newZones2 },
+  { "zones_tick_4",            opZones,         1000,  10000, zoneAdc, newZones4 },
+  { "zones_tick_8",            opZones,         1000,  10000, zoneAdc, newZones8 },
+  { "zones_tick_8_rr",         opZones,         1000,  10000, zoneAdc, newZones8RoundRobin },
+  { "zones_tick_8_dma",        opZones,         1000,  10000, zoneAdc, newZones8Dma },
+  { "adc_scan_8",              opAdcScan,       1000,  10000, fakeAdc },
+  { "coordinator_8",           opCoordinator,   1000,  10000, fakeAdc },
+  { "publish_3",               opPublish,       1000,  10000, fakeAdc },
+  { "fused_2",                 opFused2,        1000,  10000, fakeAdc },
+  { "fused_4",                 opFused4,        1000,  10000, fakeAdc },
+  { "fused_8",                 opFused8,        1000,  10000, fakeAdc },
+  { "fault_check",             opFaultCheck,    1000,  10000, fakeAdc },
+  { "pid_control",             opPidControl,    1000,  10000, fakeAdc },
+  { "predict_switch",          opPredictSwitch, 1000,  10000, fakeAdc },
+  { "adaptive_band",           opAdaptiveBand,  1000,  10000, fakeAdc },
+  { "mpc_solve",               opMpcSolve,       100,  10000, fakeAdc },
+  { "schedule_tick",           opScheduleTick,  1000,  10000, fakeAdc },
+};
+constexpr uint8_t nbrCases = sizeof(cases) / sizeof(cases[0]);
+
+void opDoMenu()        { hostSerialInput("v"); doMenu(); hostSerialInput("h"); doMenu(); }
+
+using AllocCase = struct allocCase { const char *component; BenchOp op; };
+
+AllocCase allocCases[] =
+{
+  { "NTCSensor::readSensor", opReadSensor },
+  { "Thermostat::loop",      opLoopRefresh },
+  { "doMenu",                opDoMenu },
+  { "ChangeReport",          opReport },
+  { "ZoneManager::loop",     opZones },
+  { "SensorPublisher",       opPublish },
+  { "heartbeat",             opHeartbeat },
+  { "WeeklySchedule",        opScheduleTick },
+};
+
+/**
+ * Run every hot path once to reach steady state, then 1000 times 
+ * under an AllocScope and report the heap allocations per component
+ */
+int checkAllocations()
+{
+  thermostat.setRefreshInterval(1);
+  newZones8();
+  for (AllocCase &c : allocCases) c.op();
+  heapTrackReset();
+
+  for (AllocCase &c : allocCases)
+  {
+    AllocScope scope(c.component);
+    for (int i = 0; i < 1000; i++) c.op();
+  }
+  heapTrackPrint(stdout);
+
+  int failed = 0;
+  for (AllocCase &c : allocCases)
+  {
+    if (heapTrackCount(c.component) == 0) continue;
+    printf("FAIL %s allocates at steady state\n", c.component);
+    failed++;
+  }
+  if (failed == 0) printf("no heap allocation at steady state\n");
+  return failed ? 1 : 0;
+}
+
+/**
+ * Run the heartbeat for 10 s and 8 zones cycling through their limits
+ * for 1000 ticks and compare the writes counted by the host with the 
+ * changes of the outputs. The zones commit at most one write per tick
+ * and level. Fails as well if the zones change less than WRITES_MIN_CHANGES
+ * times, since then the cache and the batch were not exercised.
+ */
+int checkGpioWrites()
+{
+  led.setup();
+  uint32_t writes = hostDigitalWrites();
+  for (int i = 0; i < 10000; i++) opHeartbeat();
+  uint32_t ledWrites = hostDigitalWrites() - writes;
+  printf("heartbeat   %6u writes in 10000 ticks, %u changes\n", (unsigned)ledWrites, (unsigned)led.getWrites());
+
+  hostSetAnalogReader(cyclingAdc);
+  newZones8();
+  uint32_t changes = 0;
+  uint32_t commits = rig->batch.getCommits();
+  for (GpioOutput &o : rig->outputs) changes -= o.getWrites();
+  writes = hostDigitalWrites();
+  for (int i = 0; i < 1000; i++) opZones();
+  uint32_t zoneWrites = hostDigitalWrites() - writes;
+  for (GpioOutput &o : rig->outputs) changes += o.getWrites();
+  commits = rig->batch.getCommits() - commits;
+  printf("zones_tick_8 %5u writes in 1000 ticks, %u changes, %u commits\n", (unsigned)zoneWrites, (unsigned)changes, (unsigned)commits);
+
+  if (changes < WRITES_MIN_CHANGES)
+  {
+    printf("FAIL %u changes of the zones, at least %u expected\n", (unsigned)changes, WRITES_MIN_CHANGES);
+    return 1;
+  }
+  bool ok = ledWrites == led.getWrites() && zoneWrites <= changes && zoneWrites <= 2 * commits;
+  printf("%s\n", ok ? "outputs written only on a change" : "FAIL outputs written without a change");
+  return ok ? 0 : 1;
+}
+
+int main(int argc, char *argv[])
+{
+  bool json = false;
+  bool checkAlloc = false;
+  bool checkWrites = false;
+  uint32_t reps = 51;
+  const char *filter = "";
+
+  for (int i = 1; i < argc; i++)
+  {
+    if      (strcmp(argv[i], "--json") == 0) json = true;
+    else if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc) reps = strtoul(argv[++i], nullptr, 10);
+    else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) filter = argv[++i];
+    else if (strcmp(argv[i], "--check-alloc") == 0) checkAlloc = true;
+    else if (strcmp(argv[i], "--check-writes") == 0) checkWrites = true;
+    else { fprintf(stderr, "usage: %s [--json] [--reps n] [--filter s] [--check-alloc] [--check-writes]\n", argv[0]); return 2; }
+  }
+
+  thermostat.setup();
+  thermostat.setOnFault(turnHeatingOff);
+  thermostat.enable();
+  for (Thermostat &t : subscribers) 
+  {
+    t.setOnFault(turnHeatingOff);
+    t.enable();
+    publisher.subscribe(t);
+  }
+  if (checkAlloc) return checkAllocations();
+  if (checkWrites) return checkGpioWrites();
+
+  Bench bench(5, reps < 3 ? 3 : reps);
+  BenchResult results[nbrCases];
+  uint8_t n = 0;
+
+  for (uint8_t i = 0; i < nbrCases; i++)
+  {
+    if (! strstr(cases[i].name, filter)) continue;
+    hostSetAnalogReader(cases[i].adc);
+    thermostat.setRefreshInterval(cases[i].msRefresh);
+    if (cases[i].setup) cases[i].setup();
+    results[n++] = bench.run(cases[i].name, cases[i].op, cases[i].nOps);
+  }
+
+  if (json)
+  {
+    printf("[\n");
+    for (uint8_t i = 0; i < n; i++) Bench::printJson(stdout, results[i], i == n - 1);
+    printf("]\n");
+  }
+  else
+  {
+    Bench::printHeader(stdout);
+    for (uint8_t i = 0; i < n; i++) Bench::printText(stdout, results[i]);
+  }
+  return 0;
+}
@@ -0,0 +1,110 @@
+/**
+ * Program      Host stand-in for the Arduino core
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the virtual clock, the fake ADC, the GPIO write
+ *              counter and the Serial sink declared in Arduino.h
+ */
+#include "Arduino.h"
+#include <cstdlib>
+
+HostSerial Serial;
+
+static uint64_t usNow = 0;
+static uint32_t nbrDigitalWrites = 0;
+static uint8_t  pinLevels[40];
+static bool     serialEcho = false;
+static char     serialIn[128];
+static size_t   serialInPos = 0;
+static size_t   serialInLen = 0;
+
+static uint16_t defaultReader(uint8_t pin) { return 2048; }
+static uint16_t (*analogReader)(uint8_t) = defaultReader;
+
+uint32_t millis() { return (uint32_t)(usNow / 1000); }
+uint32_t micros() { return (uint32_t)usNow; }
+void     delay(uint32_t ms) { usNow += 1000ULL * ms; }
+void     pinMode(uint8_t pin, uint8_t mode) {}
+int      digitalRead(uint8_t pin) { return pin < sizeof(pinLevels) ? pinLevels[pin] : LOW; }
+uint16_t analogRead(uint8_t pin) { return analogReader(pin); }
+void     analogSetAttenuation(adc_attenuation_t att) {}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+  nbrDigitalWrites++;
+  if (pin < sizeof(pinLevels)) pinLevels[pin] = val;
+}
+
+void hostGpioWrite(uint8_t bank, uint32_t mask, uint8_t val)
+{
+  nbrDigitalWrites++;
+  for (uint8_t i = 0; i < 32; i++)
+  {
+    uint8_t pin = 32 * bank + i;
+    if ((mask & (1UL << i)) && pin < sizeof(pinLevels)) pinLevels[pin] = val;
+  }
+}
+
+void     hostSetMicros(uint64_t us)      { usNow = us; }
+void     hostAdvanceMicros(uint64_t us)  { usNow += us; }
+uint64_t hostGetMicros()                 { return usNow; }
+void     hostSetAnalogReader(AnalogReader reader) { analogReader = &reader; }
+uint32_t hostDigitalWrites()             { return nbrDigitalWrites; }
+void     hostSerialEcho(bool on)         { serialEcho = on; }
+
+void hostSerialInput(const char *txt)
+{
+  strncpy(serialIn, txt, sizeof(serialIn) - 1);
+  serialInLen = strlen(serialIn);
+  serialInPos = 0;
+}
+
+
+void HostSerial::begin(unsigned long baud) {}
+
+size_t HostSerial::_write(const char *txt, size_t len)
+{
+  _bytes += len;
+  if (serialEcho) fwrite(txt, 1, len, stdout);
+  return len;
+}
+
+size_t HostSerial::printf(const char *fmt, ...)
+{
+  char buf[1024];
+  va_list args;
+  va_start(args, fmt);
+  int len = vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+  if (len < 0) return 0;
+  return _write(buf, (size_t)len < sizeof(buf) ? len : sizeof(buf) - 1);
+}
+
+size_t HostSerial::print(const char *txt)   { return _write(txt, strlen(txt)); }
+size_t HostSerial::println(const char *txt) { return print(txt) + _write("\r\n", 2); }
+size_t HostSerial::bytesWritten()           { return _bytes; }
+int    HostSerial::available()              { return (int)(serialInLen - serialInPos); }
+int    HostSerial::read()                   { return available() > 0 ? serialIn[serialInPos++] : -1; }
+
+float HostSerial::parseFloat()
+{
+  char *end;
+  while (available() > 0 && ! strchr("+-.0123456789", serialIn[serialInPos])) serialInPos++;
+  float value = strtof(&serialIn[serialInPos], &end);
+  serialInPos = end > &serialIn[serialInPos] ? end - serialIn : serialInPos + 1;
+  if (serialInPos > serialInLen) serialInPos = serialInLen;
+  while (available() > 0 && serialIn[serialInPos] <= ' ') serialInPos++;
+  return value;
+}
+
+long HostSerial::parseInt()
+{
+  char *end;
+  while (available() > 0 && ! strchr("+-0123456789", serialIn[serialInPos])) serialInPos++;
+  long value = strtol(&serialIn[serialInPos], &end, 10);
+  serialInPos = end > &serialIn[serialInPos] ? end - serialIn : serialInPos + 1;
+  if (serialInPos > serialInLen) serialInPos = serialInLen;
+  while (available() > 0 && serialIn[serialInPos] <= ' ') serialInPos++;
+  return value;
+}
@@ -0,0 +1,82 @@
+/**
+ * Program      Host stand-in for the Arduino core
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Provides the small subset of the Arduino/ESP32 API used by the
+ *              thermostat libraries so that they can be compiled and run on the
+ *              development host (benchmarks, simulation).
+ *
+ * Remarks      Time is virtual and only advances when the host program calls
+ *              hostAdvanceMicros(). analogRead() returns the value delivered by
+ *              the reader installed with hostSetAnalogReader(). Output written
+ *              to Serial is formatted but discarded unless echo is turned on.
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdarg>
+#include <cstring>
+#include <cmath>
+#include <math.h>     // isfinite() etc. in the global namespace like on the ESP32
+
+#define HIGH   0x1
+#define LOW    0x0
+#define INPUT  0x01
+#define OUTPUT 0x03
+
+#define LED_BUILTIN 2
+
+#define PI 3.1415926535897932384626433832795
+
+typedef enum { GPIO_NUM_2 = 2, GPIO_NUM_4 = 4, GPIO_NUM_16 = 16, GPIO_NUM_17 = 17, GPIO_NUM_18 = 18,
+               GPIO_NUM_19 = 19, GPIO_NUM_32 = 32, GPIO_NUM_33 = 33,
+               GPIO_NUM_34 = 34, GPIO_NUM_35 = 35, GPIO_NUM_36 = 36, GPIO_NUM_39 = 39 } gpio_num_t;
+typedef enum { ADC_0db, ADC_2_5db, ADC_6db, ADC_11db } adc_attenuation_t;
+
+using AnalogReader = uint16_t (&)(uint8_t pin);
+
+// Arduino API
+uint32_t millis();
+uint32_t micros();
+void     delay(uint32_t ms);
+void     pinMode(uint8_t pin, uint8_t mode);
+void     digitalWrite(uint8_t pin, uint8_t val);
+int      digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+void     analogSetAttenuation(adc_attenuation_t att);
+
+// Host controls
+void     hostSetMicros(uint64_t us);
+void     hostAdvanceMicros(uint64_t us);
+uint64_t hostGetMicros();          // virtual time without the wrap of micros()
+void     hostSetAnalogReader(AnalogReader reader);
+void     hostGpioWrite(uint8_t bank, uint32_t mask, uint8_t val);  // W1TS/W1TC register write of the pins in mask
+uint32_t hostDigitalWrites();     // number of digitalWrite() calls and register writes so far
+void     hostSerialEcho(bool on);  // copy Serial output to stdout
+void     hostSerialInput(const char *txt);
+
+class HostSerial
+{
+  public:
+    void   begin(unsigned long baud);
+    size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+    size_t print(const char *txt);
+    size_t println(const char *txt = "");
+    int    available();
+    int    read();
+    float  parseFloat();
+    long   parseInt();
+    size_t bytesWritten();   // number of characters formatted so far
+
+  private:
+    size_t _write(const char *txt, size_t len);
+    size_t _bytes = 0;
+};
+
+extern HostSerial Serial;
+
+#define log_i(fmt, ...) Serial.printf("[I] %s(): " fmt "\n", __func__, ##__VA_ARGS__)
+#define log_w(fmt, ...) Serial.printf("[W] %s(): " fmt "\n", __func__, ##__VA_ARGS__)
+#define log_e(fmt, ...) Serial.printf("[E] %s(): " fmt "\n", __func__, ##__VA_ARGS__)
@@ -0,0 +1,66 @@
+/**
+ * Program      Heap allocation tracking on the host
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the replacement of operator new and delete and
+ *              the table of allocation statistics per component
+ *
+ * Remarks      The table is fixed, so the tracking itself never allocates.
+ */
+#include "HeapTrack.h"
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+static constexpr int MAX_COMPONENTS = 16;
+static AllocStats table[MAX_COMPONENTS] = { { "other", 0, 0 } };
+static int nbrComponents = 1;
+static int current = 0;
+
+static int lookup(const char *component)
+{
+  for (int i = 0; i < nbrComponents; i++)
+  {
+    if (strcmp(table[i].component, component) == 0) return i;
+  }
+  if (nbrComponents == MAX_COMPONENTS) return 0;
+  table[nbrComponents] = { component, 0, 0 };
+  return nbrComponents++;
+}
+
+AllocScope::AllocScope(const char *component) : _previous(current) { current = lookup(component); }
+AllocScope::~AllocScope() { current = _previous; }
+
+uint32_t heapTrackCount(const char *component) { return table[lookup(component)].count; }
+uint64_t heapTrackBytes(const char *component) { return table[lookup(component)].bytes; }
+
+void heapTrackReset()
+{
+  for (int i = 0; i < nbrComponents; i++) table[i].count = table[i].bytes = 0;
+}
+
+void heapTrackPrint(FILE *out)
+{
+  fprintf(out, "%-24s %10s %12s\n", "component", "allocs", "bytes");
+  for (int i = 0; i < nbrComponents; i++)
+  {
+    fprintf(out, "%-24s %10u %12llu\n", table[i].component, (unsigned)table[i].count, (unsigned long long)table[i].bytes);
+  }
+}
+
+static void *track(size_t size)
+{
+  table[current].count++;
+  table[current].bytes += size;
+  void *p = malloc(size ? size : 1);
+  if (! p) throw std::bad_alloc();
+  return p;
+}
+
+void *operator new(size_t size)                { return track(size); }
+void *operator new[](size_t size)              { return track(size); }
+void  operator delete(void *p) noexcept        { free(p); }
+void  operator delete[](void *p) noexcept      { free(p); }
+void  operator delete(void *p, size_t) noexcept   { free(p); }
+void  operator delete[](void *p, size_t) noexcept { free(p); }
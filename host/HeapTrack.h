@@ -0,0 +1,37 @@
+/**
+ * Program      Heap allocation tracking on the host
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Replaces the global operator new and delete to count the
+ *              allocations and the allocated bytes per component. The
+ *              component is the one of the innermost active AllocScope,
+ *              allocations outside of any scope are booked on "other".
+ *
+ *              {
+ *                AllocScope scope("Thermostat::loop");
+ *                thermostat.loop();
+ *              }
+ *              if (heapTrackCount("Thermostat::loop")) ...
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+using AllocStats = struct allocStats { const char *component; uint32_t count; uint64_t bytes; };
+
+class AllocScope
+{
+  public:
+    AllocScope(const char *component);
+    ~AllocScope();
+
+  private:
+    int _previous;
+};
+
+uint32_t heapTrackCount(const char *component);   // allocations of the component
+uint64_t heapTrackBytes(const char *component);   // allocated bytes of the component
+void     heapTrackReset();
+void     heapTrackPrint(FILE *out);
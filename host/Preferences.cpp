@@ -0,0 +1,84 @@
+/**
+ * Class        Preferences
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the host stand-in of the Preferences with a
+ *              static table instead of the NVS flash
+ */
+#include "Preferences.h"
+
+using PrefsEntry = struct prefsEntry { char name[16]; char key[16]; uint8_t data[PREFS_MAX_BYTES]; size_t len; bool used; };
+
+static PrefsEntry entries[PREFS_MAX_ENTRIES];
+
+bool Preferences::begin(const char *name, bool readOnly)
+{
+  strncpy(_name, name, sizeof(_name) - 1);
+  _readOnly = readOnly;
+  _isOpen   = true;
+  return true;
+}
+
+void Preferences::end()
+{
+  _isOpen = false;
+}
+
+int Preferences::_find(const char *key)
+{
+  for (int i = 0; i < PREFS_MAX_ENTRIES; i++)
+  {
+    if (entries[i].used && strcmp(entries[i].name, _name) == 0 && strcmp(entries[i].key, key) == 0) return i;
+  }
+  return -1;
+}
+
+size_t Preferences::putBytes(const char *key, const void *value, size_t len)
+{
+  if (! _isOpen || _readOnly || len > PREFS_MAX_BYTES) return 0;
+  int i = _find(key);
+  for (int j = 0; i < 0 && j < PREFS_MAX_ENTRIES; j++) if (! entries[j].used) i = j;
+  if (i < 0) return 0;
+  PrefsEntry &e = entries[i];
+  memcpy(e.name, _name, sizeof(e.name));
+  strncpy(e.key, key, sizeof(e.key) - 1);
+  memcpy(e.data, value, len);
+  e.len  = len;
+  e.used = true;
+  return len;
+}
+
+size_t Preferences::getBytes(const char *key, void *buf, size_t maxLen)
+{
+  int i = _isOpen ? _find(key) : -1;
+  if (i < 0 || entries[i].len > maxLen) return 0;
+  memcpy(buf, entries[i].data, entries[i].len);
+  return entries[i].len;
+}
+
+size_t Preferences::getBytesLength(const char *key)
+{
+  int i = _isOpen ? _find(key) : -1;
+  return i < 0 ? 0 : entries[i].len;
+}
+
+bool Preferences::isKey(const char *key)
+{
+  return _isOpen && _find(key) >= 0;
+}
+
+bool Preferences::remove(const char *key)
+{
+  int i = _isOpen && ! _readOnly ? _find(key) : -1;
+  if (i < 0) return false;
+  entries[i].used = false;
+  return true;
+}
+
+bool Preferences::clear()
+{
+  if (! _isOpen || _readOnly) return false;
+  for (PrefsEntry &e : entries) if (strcmp(e.name, _name) == 0) e.used = false;
+  return true;
+}
@@ -0,0 +1,38 @@
+/**
+ * Class        Preferences
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Host stand-in for the Preferences library of the ESP32 core,
+ *              which keeps key-value pairs in the NVS flash. Only the byte
+ *              functions are provided.
+ *
+ * Remarks      The values are kept in a static table of PREFS_MAX_ENTRIES 
+ *              entries of up to PREFS_MAX_BYTES bytes, so they survive the
+ *              end() of a Preferences object but not the host program.
+ */
+#pragma once
+#include "Arduino.h"
+
+#define PREFS_MAX_ENTRIES  16
+#define PREFS_MAX_BYTES    64
+
+class Preferences
+{
+  public:
+    bool   begin(const char *name, bool readOnly = false);
+    void   end();
+    size_t putBytes(const char *key, const void *value, size_t len);
+    size_t getBytes(const char *key, void *buf, size_t maxLen);
+    size_t getBytesLength(const char *key);
+    bool   isKey(const char *key);
+    bool   remove(const char *key);
+    bool   clear();
+
+  private:
+    int    _find(const char *key);
+
+    char   _name[16] = "";
+    bool   _readOnly = true;
+    bool   _isOpen   = false;
+};
@@ -0,0 +1,107 @@
+/**
+ * Class        AdaptiveBand
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the adaption of the hysteresis band to the
+ *              target switching rate
+ *
+ * Board        ESP32 DoIt DevKit V1
+ */
+#include "AdaptiveBand.h"
+#include "TokenLog.h"
+
+#define BAND_MAX_DT     600.0f   // s, a longer gap between samples starts a new cycle
+#define BAND_MAX_STEP   2.0f     // the delta changes by at most this factor per cycle
+
+void AdaptiveBand::begin(float delta)
+{
+  _delta = delta < _p.minDelta ? _p.minDelta : delta > _p.maxDelta ? _p.maxDelta : delta;
+  _bias  = 0;
+  _rate  = 0;
+  _nbrCycles = 0;
+  restart();
+}
+
+/**
+ * Trapezoidal integral of the temperature over the cycle
+ */
+void AdaptiveBand::sample(float tCelsius, uint32_t usSample)
+{
+  float dt = (usSample - _usLast) / 1e6f;
+  if (_hasLast && dt > BAND_MAX_DT) _hasCycle = false;
+  else if (_hasLast && _hasCycle)
+  {
+    _sCycle   += dt;
+    _integral += 0.5 * (tCelsius + _tLast) * dt;
+  }
+  _usLast  = usSample;
+  _tLast   = tCelsius;
+  _hasLast = true;
+}
+
+/**
+ * A switch on ends a cycle, which adapts delta and bias. A band
+ * narrower than the limits of the thermostat stays within them,
+ * a wider one is centred on them.
+ */
+void AdaptiveBand::transition(bool on, float tLimitLow, float tLimitHigh)
+{
+  if (! on) return;
+  if (_hasCycle && _sCycle > 0)
+  {
+    _rate = 3600.0f / _sCycle;
+    float step = sqrtf(_rate / _p.cyclesPerHour);
+    step   = step < 1.0f / BAND_MAX_STEP ? 1.0f / BAND_MAX_STEP : step > BAND_MAX_STEP ? BAND_MAX_STEP : step;
+    _delta = _delta * step;
+    _delta = _delta < _p.minDelta ? _p.minDelta : _delta > _p.maxDelta ? _p.maxDelta : _delta;
+    _bias += 0.5f * ((tLimitLow + tLimitHigh) / 2 - (float)(_integral / _sCycle));
+    float maxBias = tLimitHigh - tLimitLow > _delta ? (tLimitHigh - tLimitLow - _delta) / 2 : 0;
+    _bias  = _bias < -maxBias ? -maxBias : _bias > maxBias ? maxBias : _bias;
+    _nbrCycles++;
+  }
+  _hasCycle = true;
+  _sCycle   = 0;
+  _integral = 0;
+}
+
+void AdaptiveBand::restart()
+{
+  _hasCycle = false;
+  _hasLast  = false;
+}
+
+float AdaptiveBand::getDelta()
+{
+  return _delta;
+}
+
+float AdaptiveBand::getBias()
+{
+  return _bias;
+}
+
+float AdaptiveBand::getCyclesPerHour()
+{
+  return _rate;
+}
+
+uint16_t AdaptiveBand::getCycles()
+{
+  return _nbrCycles;
+}
+
+void AdaptiveBand::setParams(const BandParams &params)
+{
+  _p = params;
+}
+
+BandParams AdaptiveBand::getParams()
+{
+  return _p;
+}
+
+void AdaptiveBand::printParams()
+{
+  TLOG("Target %.1f cycles/h, delta %.2f..%.2f °C\n", _p.cyclesPerHour, _p.minDelta, _p.maxDelta);
+  TLOG("Delta %.2f °C  bias %+.2f °C  last cycle %.2f cycles/h  cycles %u\n", _delta, _bias, _rate, (unsigned)_nbrCycles);
+}
@@ -0,0 +1,77 @@
+/**
+ * Class        AdaptiveBand
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Adapts the delta of the hysteresis of a thermostat online, so
+ *              that the relay switches about cyclesPerHour times per hour:
+ *              a well insulated room is kept in a narrower band and a drafty
+ *              room, which would cycle the relay constantly, in a wider one,
+ *              up to maxDelta, even if the band then reaches beyond the 
+ *              limits of the thermostat.
+
+ *              After every full cycle, from switch on to switch on:
+ *              - the switching rate n = 3600 s / period is compared with the
+ *                target and the delta is scaled by sqrt(n / cyclesPerHour),
+ *                the period of a relay grows about linearly with the delta,
+ *                the square root damps the steps
+ *              - the time weighted mean of the temperature over the cycle is
+ *                compared with the middle of the limits and half of the 
+ *                difference is added to the bias of the band, because heat-up
+ *                and cool-down are not equally fast and the mean of a band 
+ *                is not its middle
+ *
+ *              AdaptiveBand band(bandParamsRelay);
+ *              thermostat.setAdaptiveBand(&band);
+ *
+ * Remarks      sample() integrates the temperature, the adaption is done once
+ *              per switch on, both in O(1). The band starts with the delta
+ *              of the thermostat when set with setAdaptiveBand() and is kept
+ *              between minDelta and maxDelta. As long as it is narrower than
+ *              the limits, the bias keeps it within them. A wider band is
+ *              centred on the limits and moves both of them outwards by 
+ *              half of the excess.
+ */
+#pragma once
+#include <Arduino.h>
+
+using BandParams = struct bandParams
+{
+  float cyclesPerHour;   // target switching rate
+  float minDelta;        // °C
+  float maxDelta;        // °C
+};
+
+// Relay or SSR with a heater of some inertia
+constexpr BandParams bandParamsRelay = { 2.0f, 0.2f, 6.0f };
+
+class AdaptiveBand
+{
+  public:
+    AdaptiveBand(const BandParams &params = bandParamsRelay) : _p(params) {}
+
+    void  begin(float delta);                   // start with this delta, within min..max, and no bias
+    void  sample(float tCelsius, uint32_t usSample);
+    void  transition(bool on, float tLimitLow, float tLimitHigh);  // adapt after a full cycle
+    void  restart();                            // forget the current cycle, e.g. after a sensor fault
+    float getDelta();                           // °C
+    float getBias();                            // °C, shift of the band from the centre
+    float getCyclesPerHour();                   // of the last cycle
+    uint16_t getCycles();
+    void  setParams(const BandParams &params);
+    BandParams getParams();
+    void  printParams();
+
+  private:
+    BandParams _p;
+    float    _delta     = 3.0f;
+    float    _bias      = 0;
+    float    _rate      = 0;     // cycles per hour of the last cycle
+    uint16_t _nbrCycles = 0;
+    bool     _hasLast   = false;
+    bool     _hasCycle  = false; // a switch on has been seen
+    uint32_t _usLast    = 0;
+    float    _tLast     = 0;
+    double   _sCycle    = 0;     // duration of the cycle so far, s
+    double   _integral  = 0;     // of the temperature over the cycle, °C s
+};
@@ -0,0 +1,173 @@
+/**
+ * Class        AdcScan
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the scan of the ADC1 channels in one DMA pass
+ *
+ * Board        ESP32 DoIt DevKit V1
+ *
+ * Remarks      The DMA delivers the conversions in blocks of 
+ *              ADCSCAN_BLOCK_BYTES. scan() reads all buffered blocks without
+ *              waiting, the last code of a channel wins, so the older frames
+ *              are flushed. While its buffer is full the driver drops new
+ *              conversions, the frame is therefore at most one sample 
+ *              interval old. A channel without a conversion in the buffer
+ *              keeps its code, the frame is counted only when all channels
+ *              have been updated.
+ */
+#include "AdcScan.h"
+#include "Profiler.h"
+
+uint16_t AdcScan::getCode(uint8_t slot)
+{
+  return slot < _nbrChannels ? _codes[slot] : 0;
+}
+
+uint8_t AdcScan::getSlot(uint8_t pin)
+{
+  for (uint8_t i = 0; i < _nbrChannels; i++)
+  {
+    if (_pins[i] == pin) return i;
+  }
+  return 0xFF;
+}
+
+uint32_t AdcScan::getFrameTime()
+{
+  return _usFrame;
+}
+
+uint32_t AdcScan::getFrames()
+{
+  return _nbrFrames;
+}
+
+bool AdcScan::isRunning()
+{
+  return _isRunning;
+}
+
+#ifdef ESP32
+
+#include <driver/adc.h>
+
+#define ADCSCAN_BLOCK_BYTES  64        // conversions per DMA interrupt * SOC_ADC_DIGI_RESULT_BYTES
+#define ADCSCAN_SAMPLE_HZ    20000     // lowest rate the ESP32 supports
+#define ADCSCAN_BUFFER_BLOCKS 4        // blocks held by the driver
+
+bool AdcScan::setup()
+{
+  adc_digi_init_config_t init = {};
+  adc_digi_pattern_config_t pattern[ADCSCAN_MAX_CHANNELS] = {};
+
+  for (uint8_t i = 0; i < _nbrChannels; i++)
+  {
+    int8_t channel = digitalPinToAnalogChannel(_pins[i]);
+    if (channel < 0 || channel > 7)
+    {
+      log_e("pin %d is not an ADC1 pin", _pins[i]);
+      return false;
+    }
+    init.adc1_chan_mask |= 1 << channel;
+    pattern[i].atten     = (uint8_t)_att;   // same encoding as adc_atten_t
+    pattern[i].channel   = channel;
+    pattern[i].unit      = 0;               // ADC1
+    pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+  }
+  init.max_store_buf_size = ADCSCAN_BUFFER_BLOCKS * ADCSCAN_BLOCK_BYTES;
+  init.conv_num_each_intr = ADCSCAN_BLOCK_BYTES;
+
+  adc_digi_configuration_t cfg = {};
+  cfg.conv_limit_en  = 1;                  // required on the ESP32
+  cfg.conv_limit_num = 250;
+  cfg.pattern_num    = _nbrChannels;
+  cfg.adc_pattern    = pattern;
+  cfg.sample_freq_hz = ADCSCAN_SAMPLE_HZ;
+  cfg.conv_mode      = ADC_CONV_SINGLE_UNIT_1;
+  cfg.format         = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+
+  if (adc_digi_initialize(&init) != ESP_OK || adc_digi_controller_configure(&cfg) != ESP_OK)
+  {
+    log_e("ADC continuous mode not available");
+    return false;
+  }
+  start();
+  log_i("==> %d channels", _nbrChannels);
+  return true;
+}
+
+void AdcScan::start()
+{
+  if (_isRunning) return;
+  _isRunning = adc_digi_start() == ESP_OK;
+}
+
+void AdcScan::stop()
+{
+  if (! _isRunning) return;
+  adc_digi_stop();
+  _isRunning = false;
+}
+
+/**
+ * Drain the DMA buffer without waiting, at most the blocks it holds
+ * plus one which may arrive meanwhile
+ */
+void AdcScan::scan()
+{
+  PROFILE_SCOPE(PRB_ADC_SCAN);
+  uint8_t  block[ADCSCAN_BLOCK_BYTES];
+  uint32_t len = 0;
+  uint8_t  slotOf[8];
+  uint16_t seen = 0;
+  uint16_t all = (1 << _nbrChannels) - 1;
+
+  if (! _isRunning) return;
+  for (uint8_t i = 0; i < 8; i++) slotOf[i] = 0xFF;
+  for (uint8_t i = 0; i < _nbrChannels; i++) slotOf[digitalPinToAnalogChannel(_pins[i])] = i;
+
+  for (uint8_t n = 0; n <= ADCSCAN_BUFFER_BLOCKS && adc_digi_read_bytes(block, sizeof(block), &len, 0) == ESP_OK; n++)
+  {
+    for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= len; i += SOC_ADC_DIGI_RESULT_BYTES)
+    {
+      adc_digi_output_data_t *p = (adc_digi_output_data_t *)&block[i];
+      uint8_t ch = p->type1.channel;
+      if (ch >= 8 || slotOf[ch] == 0xFF) continue;
+      _codes[slotOf[ch]] = p->type1.data;
+      seen |= 1 << slotOf[ch];
+    }
+  }
+  if (seen != all) return;
+  _usFrame = micros();
+  _nbrFrames++;
+}
+
+#else
+
+// Host: the frame is synthesized from the fake ADC
+bool AdcScan::setup()
+{
+  start();
+  return true;
+}
+
+void AdcScan::start()
+{
+  _isRunning = true;
+}
+
+void AdcScan::stop()
+{
+  _isRunning = false;
+}
+
+void AdcScan::scan()
+{
+  PROFILE_SCOPE(PRB_ADC_SCAN);
+  if (! _isRunning) return;
+  for (uint8_t i = 0; i < _nbrChannels; i++) _codes[i] = analogRead(_pins[i]);
+  _usFrame = micros();
+  _nbrFrames++;
+}
+
+#endif
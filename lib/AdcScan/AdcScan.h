@@ -0,0 +1,60 @@
+/**
+ * Class        AdcScan
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Acquires all NTC channels in one DMA pass of ADC1. The channel
+ *              pattern is configured and the conversion started once in 
+ *              setup(), scan() then takes the newest code of every channel
+ *              from the DMA buffer and stores the codes in a frame.
+ *              A sensor attached to the scan reads its slot from the frame
+ *              instead of calling analogRead().
+ *
+ *              uint8_t pins[] = { GPIO_NUM_34, GPIO_NUM_35 };
+ *              AdcScan adcScan(pins, 2, ADC_11db);
+ *              adcScan.setup();
+ *              sensor.attachScan(adcScan);
+ *              ...
+ *              adcScan.scan();
+ *              sensor.readSensor();
+ *
+ * Remarks      On the ESP32 the continuous (DMA) mode of the ADC driver of
+ *              ESP-IDF 4.4 is used. It runs until stop(), scan() does not 
+ *              wait for conversions. analogRead() must not be used on ADC1
+ *              while the scan runs, stop() it before and start() it again
+ *              after (the zone manager does so when the scan mode changes).
+ *              On the host the frame is synthesized from the fake ADC, see 
+ *              hostSetAnalogReader().
+ *              Only ADC1 pins (32..39) can be scanned.
+ */
+#pragma once
+#include <Arduino.h>
+
+#define ADCSCAN_MAX_CHANNELS 8
+
+class AdcScan
+{
+  public:
+    AdcScan(const uint8_t *pins, uint8_t nbrChannels, adc_attenuation_t att) :
+      _pins(pins), _nbrChannels(nbrChannels < ADCSCAN_MAX_CHANNELS ? nbrChannels : ADCSCAN_MAX_CHANNELS), _att(att)
+    {}
+
+    bool     setup();                 // configure the channel pattern and start, false on error
+    void     start();                 // start the continuous conversion
+    void     stop();                  // stop it, e.g. for analogRead() on ADC1
+    bool     isRunning();
+    void     scan();                  // take the newest frame of all channels
+    uint16_t getCode(uint8_t slot);   // code of the slot in the last frame
+    uint8_t  getSlot(uint8_t pin);    // slot of the pin, 0xFF if not scanned
+    uint32_t getFrameTime();          // µs, micros() when the last frame was acquired
+    uint32_t getFrames();             // number of frames acquired
+
+  private:
+    const uint8_t    *_pins;
+    uint8_t           _nbrChannels;
+    adc_attenuation_t _att;
+    uint16_t          _codes[ADCSCAN_MAX_CHANNELS] = {};
+    uint32_t          _usFrame = 0;
+    uint32_t          _nbrFrames = 0;
+    bool              _isRunning = false;
+};
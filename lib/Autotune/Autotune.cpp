@@ -0,0 +1,170 @@
+/**
+ * Class        Autotune
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the relay-feedback autotuning
+ *
+ * Board        ESP32 DoIt DevKit V1
+ */
+#include "Autotune.h"
+#include "TokenLog.h"
+
+#define TUNE_RELAY_AMPLITUDE  0.5f   // d, half of the step of the control value 0..1
+#define TUNE_NOISE_SIGMAS     3.0f   // hysteresis in standard deviations of the noise
+
+/**
+ * Relay with hysteresis around the setpoint, which holds for the 
+ * minimum half period after a switch. While the tuning runs, every 
+ * switch on ends a cycle, whose period and amplitude are recorded.
+ */
+float Autotune::control(float tCelsius, float tSetpoint, uint32_t usSample)
+{
+  if (_hasLast) _msElapsed += (usSample - _usLast) / 1000;
+  _usLast  = usSample;
+  _hasLast = true;
+
+  bool wasOn = _isOn;
+  if (_msElapsed - _msSwitch >= _msMinHalfPeriod)
+  {
+    if      (tCelsius < tSetpoint - _hysteresis) _isOn = true;
+    else if (tCelsius > tSetpoint + _hysteresis) _isOn = false;
+    if (_isOn != wasOn) _msSwitch = _msElapsed;
+  }
+  if (_state != TUNE_RUNNING) return _isOn ? 1.0f : 0.0f;
+
+  _tMax = tCelsius > _tMax ? tCelsius : _tMax;
+  _tMin = tCelsius < _tMin ? tCelsius : _tMin;
+  if (_isOn && ! wasOn)
+  {
+    if (_cycle >= 1)
+    {
+      _sumPeriod    += (_msElapsed - _msLastOn) / 1000.0f;
+      _sumAmplitude += (_tMax - _tMin) / 2;
+    }
+    _cycle++;
+    _msLastOn = _msElapsed;
+    _tMax = _tMin = tCelsius;
+    if (_cycle > _nbrCycles) _finish();
+  }
+  if (_state == TUNE_RUNNING && _msElapsed > _msTimeout)
+  {
+    _state = TUNE_FAILED;
+    log_w("no oscillation after %u s", (unsigned)(_msTimeout / 1000));
+  }
+  return _isOn ? 1.0f : 0.0f;
+}
+
+/**
+ * Ultimate gain and period from the mean of the measured cycles,
+ * then the gains by Ziegler-Nichols
+ */
+void Autotune::_finish()
+{
+  _period    = _sumPeriod / _nbrCycles;
+  _amplitude = _sumAmplitude / _nbrCycles;
+  if (_amplitude <= _hysteresis)
+  {
+    _state = TUNE_FAILED;
+    log_w("amplitude %.2f °C not above the hysteresis", _amplitude);
+    return;
+  }
+  _ku = 4.0f * TUNE_RELAY_AMPLITUDE / (PI * sqrtf(_amplitude * _amplitude - _hysteresis * _hysteresis));
+  float kp = 0.6f * _ku;
+  float ti = _period / 2.0f;
+  float td = _period / 8.0f;
+  _params = { kp, kp / ti, kp * td, td / 10.0f };
+  _state  = TUNE_DONE;
+  log_i("Pu %.0f s, a %.2f °C, Ku %.3f /°C", _period, _amplitude, _ku);
+}
+
+/**
+ * The hysteresis is set from the noise of the temperature
+ */
+void Autotune::start(float tNoise)
+{
+  float hysteresis = TUNE_NOISE_SIGMAS * tNoise;
+  _hysteresis = hysteresis > _minHysteresis ? hysteresis : _minHysteresis;
+  _restart();
+}
+
+void Autotune::_restart()
+{
+  _state     = TUNE_RUNNING;
+  _cycle     = -1;
+  _msElapsed = 0;
+  _msLastOn  = 0;
+  _sumPeriod = 0;
+  _sumAmplitude = 0;
+  _hasLast   = false;
+  _msSwitch  = 0 - _msMinHalfPeriod;
+}
+
+void Autotune::stop()
+{
+  if (_state == TUNE_RUNNING) _state = TUNE_IDLE;
+}
+
+/**
+ * A running tuning starts again, the relay starts off
+ */
+void Autotune::reset()
+{
+  _isOn    = false;
+  _hasLast = false;
+  if (_state == TUNE_RUNNING) _restart();
+}
+
+TuneState Autotune::getState()
+{
+  return _state;
+}
+
+uint8_t Autotune::getCycles()
+{
+  return _cycle > 0 ? _cycle - 1 : 0;
+}
+
+float Autotune::getHysteresis()
+{
+  return _hysteresis;
+}
+
+float Autotune::getPeriod()
+{
+  return _period;
+}
+
+float Autotune::getAmplitude()
+{
+  return _amplitude;
+}
+
+float Autotune::getUltimateGain()
+{
+  return _ku;
+}
+
+PidParams Autotune::getParams()
+{
+  return _params;
+}
+
+const char* Autotune::stateName(TuneState state)
+{
+  static const char * const names[] = { "idle", "running", "done", "failed" };
+  return state <= TUNE_FAILED ? names[state] : "unknown";
+}
+
+void Autotune::printParams()
+{
+  int      cycle = getCycles();
+  unsigned s     = _msElapsed / 1000;
+  switch (_state)
+  {
+    case TUNE_IDLE:    TLOG("Autotune idle, hysteresis %.2f °C, cycle %d of %d, %u s elapsed\n", _hysteresis, cycle, _nbrCycles, s);    break;
+    case TUNE_RUNNING: TLOG("Autotune running, hysteresis %.2f °C, cycle %d of %d, %u s elapsed\n", _hysteresis, cycle, _nbrCycles, s); break;
+    case TUNE_DONE:    TLOG("Autotune done, hysteresis %.2f °C, cycle %d of %d, %u s elapsed\n", _hysteresis, cycle, _nbrCycles, s);    break;
+    default:           TLOG("Autotune failed, hysteresis %.2f °C, cycle %d of %d, %u s elapsed\n", _hysteresis, cycle, _nbrCycles, s);  break;
+  }
+  if (_state == TUNE_DONE) TLOG("Pu %.0f s  a %.2f °C  Ku %.3f /°C\n", _period, _amplitude, _ku);
+}
@@ -0,0 +1,94 @@
+/**
+ * Class        Autotune
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Relay-feedback autotuning of the PID gains (Åström-Hägglund).
+ *              As control law of a thermostat it switches the heater like
+ *              the hysteresis, on below setpoint - hysteresis and off above
+ *              setpoint + hysteresis, so the room oscillates around the
+ *              setpoint. The time of every switch on is taken from the
+ *              samples, the extremes of the temperature in between are
+ *              tracked. After the first cycle, which is skipped, nbrCycles
+ *              cycles are measured and give the period Pu and the amplitude
+ *              a of the oscillation. With the relay amplitude d = 0.5 the
+ *              ultimate gain is
+ *
+ *              Ku = 4 d / (π sqrt(a² - ε²))      ε = hysteresis
+ *
+ *              and the PID gains follow the rule of Ziegler-Nichols:
+ *              Kp = 0.6 Ku, Ti = Pu / 2, Td = Pu / 8, Tf = Td / 10.
+ *
+ *              autotune.start(sensor.getNoiseCelsius());
+ *              thermostat.setControlLaw(&autotune);
+ *              ...
+ *              if (autotune.getState() == TUNE_DONE) pid.setParams(autotune.getParams());
+ *
+ * Remarks      The hysteresis of the autotune is narrower than the limits
+ *              of the thermostat, so that a cycle of a heavy room takes an
+ *              hour or two and not half a day. It is 3 times the noise of
+ *              the temperature passed to start(), at least minHysteresis,
+ *              so the relay does not switch on noise. After a switch the
+ *              relay holds for msMinHalfPeriod, so no cycle is shorter than
+ *              twice of it. The relay keeps running after the tuning until
+ *              the law is replaced. The tuning fails when no result is
+ *              available after msTimeout or the amplitude is not above the
+ *              hysteresis.
+ */
+#pragma once
+#include "IControlLaw.h"
+#include "PidLaw.h"
+
+using TuneState = enum tuneState { TUNE_IDLE, TUNE_RUNNING, TUNE_DONE, TUNE_FAILED };
+
+class Autotune : public IControlLaw
+{
+  public:
+    Autotune(float minHysteresis = 0.2f, uint8_t nbrCycles = 3, uint32_t msTimeout = 48UL * 3600000, 
+             uint32_t msMinHalfPeriod = 300000) :
+      _minHysteresis(minHysteresis), _hysteresis(minHysteresis), _nbrCycles(nbrCycles), _msTimeout(msTimeout),
+      _msMinHalfPeriod(msMinHalfPeriod), _msSwitch(0 - msMinHalfPeriod)
+    {}
+
+    float control(float tCelsius, float tSetpoint, uint32_t usSample) override;
+    void  reset() override;    // restart a running tuning
+    const char* getName() override { return "autotune"; }
+    ControlLawCode getCode() override { return LAW_AUTOTUNE; }
+    void  printParams() override;
+    void  start(float tNoise = 0);  // start a tuning, tNoise is the sigma of the temperature in °C
+    void  stop();              // stop a running tuning
+    TuneState getState();
+    uint8_t   getCycles();     // cycles measured so far
+    float     getHysteresis(); // °C
+    float     getPeriod();     // Pu in s
+    float     getAmplitude();  // a in °C
+    float     getUltimateGain();  // Ku in 1/°C
+    PidParams getParams();     // gains of the last successful tuning
+    static const char* stateName(TuneState state);
+
+  private:
+    void _restart();
+    void _finish();
+
+    float     _minHysteresis;  // °C
+    float     _hysteresis;     // °C
+    uint8_t   _nbrCycles;
+    uint32_t  _msTimeout;
+    uint32_t  _msMinHalfPeriod;
+    uint32_t  _msSwitch;       // time of the last switch of the relay
+    TuneState _state     = TUNE_IDLE;
+    bool      _isOn      = false;
+    bool      _hasLast   = false;
+    uint32_t  _usLast    = 0;
+    uint32_t  _msElapsed = 0;  // since start, wraps after 49 days
+    uint32_t  _msLastOn  = 0;  // time of the last switch on
+    int8_t    _cycle     = -1; // -1 before the first switch on, 0 during the skipped cycle
+    float     _tMax      = 0;  // extremes of the current cycle
+    float     _tMin      = 0;
+    float     _sumPeriod = 0;  // s
+    float     _sumAmplitude = 0;
+    float     _period    = 0;
+    float     _amplitude = 0;
+    float     _ku        = 0;
+    PidParams _params    = pidParamsOilRadiator;
+};
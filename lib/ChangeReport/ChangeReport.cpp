@@ -0,0 +1,38 @@
+/**
+ * Class        ChangeReport
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the dirty tracking of the report fields
+ *
+ * Board        ESP32 DoIt DevKit V1
+ */
+#include "ChangeReport.h"
+
+/**
+ * A report is a keyframe when requested, when change-driven
+ * reporting is disabled or every keyframeInterval reports
+ */
+void ChangeReport::begin()
+{
+  _isKeyframe = _keyframeRequested || ! _isEnabled || _nbrReports >= _keyframeInterval;
+  _keyframeRequested = false;
+  _nbrReports = _isKeyframe ? 1 : _nbrReports + 1;
+}
+
+/**
+ * Returns true if the field must be emitted, i.e. in a keyframe or when
+ * its value quantized to the printed resolution differs from the last
+ * emitted one. The emitted value is remembered. A value which is not
+ * finite or out of range, e.g. the NaN of a faulty sensor, is quantized
+ * to REPORT_FAULT, so the change to and from it is emitted once.
+ */
+bool ChangeReport::changed(ReportField field, double value, double resolution)
+{
+  double  r = value / resolution;
+  int32_t q = isfinite(r) && fabs(r) < INT32_MAX ? (int32_t)lround(r) : REPORT_FAULT;
+  uint32_t bit = 1UL << field;
+  if (! _isKeyframe && (_isValid & bit) && _last[field] == q) return false;
+  _last[field] = q;
+  _isValid |= bit;
+  return true;
+}
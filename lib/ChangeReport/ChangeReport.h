@@ -0,0 +1,54 @@
+/**
+ * Class        ChangeReport
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Change-driven reporting. The reporting functions ask for every
+ *              field whether it has changed at the resolution it is printed
+ *              with since it was last emitted, and print only the changed
+ *              fields. Every keyframeInterval reports, or when requested, a
+ *              keyframe is emitted which contains all fields.
+ *
+ *              report.begin();
+ *              if (report.changed(RF_TC, _sData.tCelsius, 0.1)) TLOG("Tc  %5.1f °C\n", ...);
+ *
+ * Remarks      When disabled, every report is a keyframe, i.e. the full
+ *              output as before.
+ */
+#pragma once
+#include <Arduino.h>
+
+#define REPORT_FAULT  INT32_MIN   // quantized value of a value which is not finite
+
+// Add new fields in front of RF_COUNT
+using ReportField = enum reportField
+{
+  RF_BETA, RF_RO, RF_RS, RF_ROO, RF_PIN, RF_AMAX, RF_NTC_TO, RF_VCC, RF_VREF, RF_VOFF,
+  RF_AVAL, RF_V, RF_VIN, RF_K, RF_RT, RF_TC, RF_TF, RF_TK,
+  RF_LIMIT_HIGH, RF_DELTA, RF_LIMIT_LOW, RF_REFRESH, RF_ENABLED, RF_SWITCH, RF_FAULT,
+  RF_COUNT
+};
+
+class ChangeReport
+{
+  public:
+    ChangeReport(uint16_t keyframeInterval = 30) : _keyframeInterval(keyframeInterval) {}
+
+    void begin();   // begin a new report
+    bool changed(ReportField field, double value, double resolution);
+    bool isKeyframe() { return _isKeyframe; }
+    void requestKeyframe() { _keyframeRequested = true; }
+    void setKeyframeInterval(uint16_t n) { _keyframeInterval = n; }
+    void enable()  { _isEnabled = true; }
+    void disable() { _isEnabled = false; }
+    bool isEnabled() { return _isEnabled; }
+
+  private:
+    int32_t  _last[RF_COUNT];
+    uint32_t _isValid = 0;               // bit per field, last value known
+    uint16_t _keyframeInterval;
+    uint16_t _nbrReports = 0;            // reports since last keyframe
+    bool     _isKeyframe = true;
+    bool     _keyframeRequested = true;
+    bool     _isEnabled = true;
+};
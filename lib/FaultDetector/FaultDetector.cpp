@@ -0,0 +1,18 @@
+/**
+ * Class        FaultDetector
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Names of the sensor faults
+ *
+ * Board        ESP32 DoIt DevKit V1
+ */
+#include "FaultDetector.h"
+
+const char* FaultDetector::faultName(SensorFault fault)
+{
+  static const char * const names[] = 
+  {
+    "none", "rail low", "rail high", "not finite", "stuck", "jump", "no input"
+  };
+  return fault <= FAULT_NO_INPUT ? names[fault] : "unknown";
+}
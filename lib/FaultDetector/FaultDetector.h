@@ -0,0 +1,72 @@
+/**
+ * Class        FaultDetector
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Classifies each reading of an NTC in O(1):
+ *              - rail       the analog value is within railMargin of 0 or of
+ *                           analogMax, the NTC is open or shorted
+ *              - not finite the temperature is inf or NaN
+ *              - stuck      the analog value has been the same for nStuck 
+ *                           samples, a real ADC always shows some noise
+ *              - jump       the temperature changed by more than 
+ *                           maxJump + maxRate * dt since the last sample
+ *
+ *              _fault = _detector.check(_sData.analogValue, _adc.Amax, 
+ *                                       _sData.tCelsius, _sData.usSample);
+ *
+ * Remarks      nStuck = 0 disables the stuck detection, e.g. for a simulated
+ *              ADC without noise. After a fault the next sample is not
+ *              checked for a jump, so a recovered sensor is accepted again.
+ */
+#pragma once
+#include <Arduino.h>
+#include "ISensor.h"
+
+using FaultParams = struct faultParams 
+{ 
+  uint16_t railMargin;   // ADC codes
+  uint16_t nStuck;       // samples, 0 = off
+  float    maxJump;      // °C
+  float    maxRate;      // °C/s
+};
+
+constexpr FaultParams faultParamsNTC = { 8, 600, 1.0f, 0.02f };
+
+class FaultDetector
+{
+  public:
+    FaultDetector(const FaultParams &params = faultParamsNTC) : _p(params) {}
+
+    SensorFault check(uint16_t analogValue, uint16_t analogMax, float tCelsius, uint32_t usSample)
+    {
+      SensorFault fault = FAULT_NONE;
+      _nSame = analogValue != _lastValue ? 0 : _nSame < 0xFFFF ? _nSame + 1 : _nSame;
+      _lastValue = analogValue;
+
+      if      (analogValue <= _p.railMargin)              fault = FAULT_RAIL_LOW;
+      else if (analogValue >= analogMax - _p.railMargin)  fault = FAULT_RAIL_HIGH;
+      else if (! isfinite(tCelsius))                      fault = FAULT_NOT_FINITE;
+      else if (_p.nStuck && _nSame >= _p.nStuck)          fault = FAULT_STUCK;
+      else if (_hasLast && fabsf(tCelsius - _tLast) > _p.maxJump + _p.maxRate * 1e-6f * (usSample - _usLast)) 
+                                                          fault = FAULT_JUMP;
+      _hasLast = fault == FAULT_NONE;
+      _tLast   = tCelsius;
+      _usLast  = usSample;
+      if (fault != FAULT_NONE) _nbrFaults++;
+      return fault;
+    }
+
+    void     setParams(const FaultParams &params) { _p = params; }
+    uint32_t getNbrFaults() { return _nbrFaults; }   // faulty samples since start
+    static const char* faultName(SensorFault fault);
+
+  private:
+    FaultParams _p;
+    uint16_t    _lastValue = 0;
+    uint16_t    _nSame     = 0;
+    float       _tLast     = 0;
+    uint32_t    _usLast    = 0;
+    bool        _hasLast   = false;
+    uint32_t    _nbrFaults = 0;
+};
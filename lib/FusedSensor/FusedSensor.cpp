@@ -0,0 +1,133 @@
+/**
+ * Class        FusedSensor
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the fusion of several temperature sensors
+ *
+ * Board        ESP32 DoIt DevKit V1
+ */
+#include "FusedSensor.h"
+
+void FusedSensor::setup()
+{
+  for (uint8_t i = 0; i < _nbrInputs; i++) _inputs[i].sensor.setup();
+  readSensor();
+  log_i("==> %d inputs", _nbrInputs);
+}
+
+void FusedSensor::readSensor()
+{
+  _sData.usSample = micros();
+  _sData.seq++;
+  for (uint8_t i = 0; i < _nbrInputs; i++) _inputs[i].sensor.readSensor();
+  _fuse();
+}
+
+// Plausible temperature of a room sensor
+static inline bool isValid(float t)
+{
+  return isfinite(t) && t >= -40.0f && t <= 125.0f;
+}
+
+/**
+ * Weighted mean of the valid readings which are close to their median.
+ * Readings of inputs which report a fault are not valid.
+ */
+void FusedSensor::_fuse()
+{
+  float   t[FUSED_MAX_INPUTS];
+  float   sorted[FUSED_MAX_INPUTS];
+  uint8_t nbrValid = 0;
+  uint8_t validMask = 0;
+  float   wTotal = 0;
+
+  for (uint8_t i = 0; i < _nbrInputs; i++)
+  {
+    t[i] = _inputs[i].sensor.getCelsius();
+    wTotal += _inputs[i].weight;
+    if (! isValid(t[i]) || _inputs[i].sensor.getFault() != FAULT_NONE) continue;
+    validMask |= 1 << i;
+    uint8_t j = nbrValid++;                  // insertion sort, at most 8 values
+    for (; j > 0 && sorted[j - 1] > t[i]; j--) sorted[j] = sorted[j - 1];
+    sorted[j] = t[i];
+  }
+
+  _nbrAccepted = 0;
+  _fault = nbrValid == 0 ? FAULT_NO_INPUT : FAULT_NONE;
+  if (nbrValid == 0)
+  {
+    _quality = 0;
+    return;
+  }
+
+  float median = nbrValid & 1 ? sorted[nbrValid / 2] : (sorted[nbrValid / 2 - 1] + sorted[nbrValid / 2]) / 2;
+  float sumWT = 0;
+  float sumW  = 0;
+  int8_t best = -1;
+  for (uint8_t i = 0; i < _nbrInputs; i++)
+  {
+    if (! (validMask & (1 << i))) continue;
+    if (best < 0 || _inputs[i].weight > _inputs[best].weight) best = i;
+    if (fabsf(t[i] - median) > _maxDeviation) continue;
+    sumWT += _inputs[i].weight * t[i];
+    sumW  += _inputs[i].weight;
+    _nbrAccepted++;
+  }
+  if (_nbrAccepted == 0)                     // no agreement, trust the heaviest input
+  {
+    sumWT = _inputs[best].weight * t[best];
+    sumW  = _inputs[best].weight;
+    _nbrAccepted = 1;
+  }
+  if (sumW <= 0)
+  {
+    _quality = 0;
+    return;
+  }
+
+  _quality = wTotal > 0 ? sumW / wTotal : 0;
+  _sData.tCelsius    = sumWT / sumW;
+  _sData.tKelvin     = _sData.tCelsius - _sData.Tabs;
+  _sData.tFahrenheit = _sData.tCelsius * 9.0 / 5.0 + 32.0;
+}
+
+float FusedSensor::getCelsius()
+{
+  return _sData.tCelsius;
+}
+
+SensorData& FusedSensor::getDataReference()
+{
+  return _sData;
+}
+
+SensorFault FusedSensor::getFault()
+{
+  return _fault;
+}
+
+float FusedSensor::getQuality()
+{
+  return _quality;
+}
+
+uint8_t FusedSensor::getNbrAccepted()
+{
+  return _nbrAccepted;
+}
+
+/**
+ * Print the temperatures of the inputs and the fused values
+ */
+void FusedSensor::printData()
+{
+  Serial.printf("--- Fused Sensor ---\n");
+  for (uint8_t i = 0; i < _nbrInputs; i++)
+  {
+    Serial.printf("Input %d     %5.1f °C  weight %4.1f\n", i, _inputs[i].sensor.getCelsius(), _inputs[i].weight);
+  }
+  Serial.printf(R"(Tc         %5.1f °C
+Quality    %5.2f  (%d of %d inputs)
+
+)", _sData.tCelsius, _quality, _nbrAccepted, _nbrInputs);
+}
@@ -0,0 +1,63 @@
+/**
+ * Class        FusedSensor
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Combines several sensors of the same room into one ISensor,
+ *              e.g. two NTCs or an NTC and a BME280 for redundancy, so that
+ *              the Thermostat can use it unchanged. readSensor() reads all
+ *              inputs and fuses their temperatures:
+ *              - readings which are not finite or outside -40..125 °C and
+ *                readings of inputs which report a fault are invalid
+ *              - valid readings further than maxDeviation from their median 
+ *                are rejected as outliers
+ *              - the fused temperature is the weighted mean of the accepted 
+ *                readings
+ *              - the quality is the share of the weight of the accepted 
+ *                inputs in the total weight, 1.0 when all inputs agree
+ *
+ *              FusedInput inputs[] = { { ntc1, 1.0 }, { ntc2, 1.0 }, { bme, 2.0 } };
+ *              FusedSensor room(inputs, 3, roomData);
+ *              Thermostat thermostat(room, processData, turnHeatingOn, turnHeatingOff);
+ *
+ * Remarks      When the valid inputs disagree and none is close to the median, 
+ *              which happens with 2 inputs, the input with the highest weight 
+ *              is taken. When no input is valid the last temperature is kept,
+ *              the quality is 0 and getFault() returns FAULT_NO_INPUT.
+ */
+#pragma once
+#include <Arduino.h>
+#include "ISensor.h"
+
+#define FUSED_MAX_INPUTS 8
+
+using FusedInput = struct fusedInput { ISensor &sensor; float weight; };
+
+class FusedSensor : public ISensor
+{
+  public:
+    FusedSensor(FusedInput *inputs, uint8_t nbrInputs, SensorData &sensorData, float maxDeviation = 1.5f) :
+      _inputs(inputs), _nbrInputs(nbrInputs < FUSED_MAX_INPUTS ? nbrInputs : FUSED_MAX_INPUTS), 
+      _sData(sensorData), _maxDeviation(maxDeviation)
+    {}
+
+    void  setup() override;
+    void  readSensor() override;  // read all inputs and fuse their temperatures
+    float getCelsius() override;
+    void  printData() override;
+    SensorData& getDataReference() override;
+    SensorFault getFault() override;
+    float   getQuality();         // 0..1
+    uint8_t getNbrAccepted();     // inputs in the fused value
+
+  private:
+    void  _fuse();
+
+    FusedInput *_inputs;
+    uint8_t     _nbrInputs;
+    SensorData &_sData;
+    float       _maxDeviation;    // °C
+    float       _quality     = 0;
+    uint8_t     _nbrAccepted = 0;
+    SensorFault _fault       = FAULT_NONE;
+};
@@ -0,0 +1,101 @@
+/**
+ * Class        GpioOutput, GpioBatch
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the cached GPIO output and the batched
+ *              register writes
+ *
+ * Board        ESP32 DoIt DevKit V1
+ */
+#include "GpioOutput.h"
+
+#ifdef ESP32
+#include <soc/gpio_struct.h>
+#endif
+
+void GpioOutput::setup()
+{
+  pinMode(_pin, OUTPUT);
+  digitalWrite(_pin, LOW);
+  _isOn = false;
+  _nbrWrites = 0;
+}
+
+void GpioOutput::set(bool on)
+{
+  if (on == _isOn) return;
+  _isOn = on;
+  _nbrWrites++;
+  if (_batch) _batch->stage(_pin, on);
+  else        digitalWrite(_pin, on ? HIGH : LOW);
+}
+
+/**
+ * Written at once to the W1TS or W1TC register of the bank, which only
+ * touches the pin, so it does not interfere with a commit of the batch
+ */
+void GpioOutput::setNow(bool on)
+{
+  if (on == _isOn) return;
+  _isOn = on;
+  _nbrWrites++;
+  uint32_t mask = 1UL << (_pin & 31);
+#ifdef ESP32
+  if (_pin < 32) { if (on) GPIO.out_w1ts = mask;     else GPIO.out_w1tc = mask; }
+  else           { if (on) GPIO.out1_w1ts.val = mask; else GPIO.out1_w1tc.val = mask; }
+#else
+  hostGpioWrite(_pin >> 5, mask, on ? HIGH : LOW);
+#endif
+}
+
+bool GpioOutput::isOn()
+{
+  return _isOn;
+}
+
+uint32_t GpioOutput::getWrites()
+{
+  return _nbrWrites;
+}
+
+uint8_t GpioOutput::getPin()
+{
+  return _pin;
+}
+
+/**
+ * A later change of the same pin replaces the staged one
+ */
+void GpioBatch::stage(uint8_t pin, bool on)
+{
+  uint8_t  bank = pin >> 5;
+  uint32_t mask = 1UL << (pin & 31);
+  if (bank > 1) return;
+  if (on) { _set[bank] |= mask;   _clear[bank] &= ~mask; }
+  else    { _clear[bank] |= mask; _set[bank] &= ~mask; }
+}
+
+bool GpioBatch::commit()
+{
+  if (! (_set[0] | _clear[0] | _set[1] | _clear[1])) return false;
+#ifdef ESP32
+  if (_set[0])   GPIO.out_w1ts = _set[0];
+  if (_clear[0]) GPIO.out_w1tc = _clear[0];
+  if (_set[1])   GPIO.out1_w1ts.val = _set[1];
+  if (_clear[1]) GPIO.out1_w1tc.val = _clear[1];
+#else
+  for (uint8_t bank = 0; bank < 2; bank++)
+  {
+    if (_set[bank])   hostGpioWrite(bank, _set[bank], HIGH);
+    if (_clear[bank]) hostGpioWrite(bank, _clear[bank], LOW);
+  }
+#endif
+  _set[0] = _set[1] = _clear[0] = _clear[1] = 0;
+  _nbrCommits++;
+  return true;
+}
+
+uint32_t GpioBatch::getCommits()
+{
+  return _nbrCommits;
+}
@@ -0,0 +1,62 @@
+/**
+ * Class        GpioOutput, GpioBatch
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      On/off output on a GPIO pin with cached state. Without a
+ *              batch a change is written at once with digitalWrite().
+ *              With a batch, the changes of several outputs are collected
+ *              in set and clear masks and commit() writes them with one
+ *              write to the W1TS and W1TC registers of the GPIO bank, so
+ *              the heaters of a multi-zone board switch in the same
+ *              instant and the loop pays one register write per bank:
+ *
+ *              GpioBatch  batch;
+ *              GpioOutput heaters[] = { { GPIO_NUM_4, &batch }, { GPIO_NUM_16, &batch } };
+ *              heaters[0].set(true);
+ *              heaters[1].set(false);
+ *              batch.commit();
+ *
+ * Remarks      Bank 0 holds the pins 0..31, bank 1 the pins 32..39. The
+ *              W1TS and W1TC registers only touch the bits set in the mask,
+ *              so outputs outside the batch, e.g. the heartbeat LED, are not
+ *              affected. A batch must not be used from a timer or an ISR,
+ *              setNow() writes the pin of an output of a batch at once with
+ *              its own W1TS or W1TC write, e.g. from the timer of a SlowPwm.
+ *              On the host the register writes go to hostGpioWrite(),
+ *              which counts them with hostDigitalWrites().
+ */
+#pragma once
+#include "IActuator.h"
+
+class GpioBatch
+{
+  public:
+    void     stage(uint8_t pin, bool on);   // change to be written by commit()
+    bool     commit();                      // write the staged changes, true if any
+    uint32_t getCommits();                  // commits which wrote
+
+  private:
+    uint32_t _set[2]     = { 0, 0 };        // masks of bank 0 and bank 1
+    uint32_t _clear[2]   = { 0, 0 };
+    uint32_t _nbrCommits = 0;
+};
+
+class GpioOutput : public IActuator
+{
+  public:
+    GpioOutput(uint8_t pin, GpioBatch *batch = nullptr) : _pin(pin), _batch(batch) {}
+
+    void     setup() override;
+    void     set(bool on) override;
+    void     setNow(bool on) override;
+    bool     isOn() override;
+    uint32_t getWrites() override;
+    uint8_t  getPin();
+
+  private:
+    uint8_t    _pin;
+    GpioBatch *_batch;
+    volatile bool     _isOn      = false;   // also written by setNow() in a timer task
+    volatile uint32_t _nbrWrites = 0;
+};
@@ -0,0 +1,18 @@
+#pragma once
+#include <Arduino.h>
+
+/**
+ * Actuator interface of the on/off outputs. The state is cached, set()
+ * writes to the hardware only when the state changes, so it can be called
+ * with the decision of every tick. getWrites() counts the changes written.
+ * setNow() writes a change at once, for outputs timed by a timer.
+ */
+class IActuator
+{
+  public:
+    virtual void     setup() = 0;           // configure the output, off
+    virtual void     set(bool on) = 0;      // switch, written only on a change
+    virtual void     setNow(bool on) = 0;   // switch at once past any batch, may be called from a timer
+    virtual bool     isOn() = 0;            // cached state
+    virtual uint32_t getWrites() = 0;       // changes written since setup()
+};
@@ -0,0 +1,23 @@
+#pragma once
+#include <Arduino.h>
+
+enum ControlLawCode : uint8_t { LAW_PID, LAW_AUTOTUNE, LAW_MPC };
+
+/**
+ * Control law interface of the Thermostat. control() is called with every 
+ * evaluated sample and returns the heating power as control value 0..1,
+ * which drives a time-proportional output directly and an on/off output
+ * with a threshold of 0.5. usSample is the time of the sample in µs.
+ * reset() clears the state of the law, e.g. after a sensor fault.
+ * getCode() identifies the law in the settings printed with TLOG,
+ * which cannot print the name.
+ */
+class IControlLaw
+{
+  public:
+    virtual float control(float tCelsius, float tSetpoint, uint32_t usSample) = 0; // control value 0..1
+    virtual void  reset() = 0;              // clear the state
+    virtual const char* getName() = 0;      // name for the CLI
+    virtual ControlLawCode getCode() = 0;   // code for the settings
+    virtual void  printParams() {}          // print the parameters of the law
+};
@@ -1,6 +1,18 @@
 #pragma once
 #include "SensorData.h"
 
+// Classification of the sensor readings, see FaultDetector.h
+using SensorFault = enum sensorFault
+{
+  FAULT_NONE,
+  FAULT_RAIL_LOW,     // analog value at 0, NTC to GND shorted or NTC to Vcc open
+  FAULT_RAIL_HIGH,    // analog value at max, NTC to GND open or NTC to Vcc shorted
+  FAULT_NOT_FINITE,   // temperature is inf or NaN
+  FAULT_STUCK,        // analog value has not changed over the window
+  FAULT_JUMP,         // implausible change since the last sample
+  FAULT_NO_INPUT,     // no valid input (composite sensors)
+};
+
 /**
  * Sensor interface is a pure abstract class. It declares the
  * methods that must be implemented by the inheriting sensor class
@@ -13,4 +25,5 @@ class ISensor
     virtual float getCelsius() = 0; // returns the temperature in °C
     virtual void printData()   = 0; // print the data read from the sensor data struct
     virtual SensorData& getDataReference() = 0; // get a reference to the sensor data struct
+    virtual SensorFault getFault() { return FAULT_NONE; } // fault of the last reading
 };
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+#include "SensorData.h"
+
+/**
+ * Subscriber interface of the SensorPublisher. onSample() is called 
+ * with a reference to the data of each new acquisition of the sensor, 
+ * data.seq identifies the sample. The data must not be modified.
+ */
+class ISubscriber
+{
+  public:
+    virtual void onSample(const SensorData &data) = 0; // evaluate a new sample
+};
@@ -0,0 +1,49 @@
+/**
+ * Class        LogHistogram
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the histogram with logarithmic buckets
+ *
+ * Board        ESP32 DoIt DevKit V1
+ */
+#include "LogHistogram.h"
+
+void LogHistogram::reset()
+{
+  memset(_buckets, 0, sizeof(_buckets));
+  _count = 0;
+  _max   = 0;
+}
+
+/**
+ * Returns the upper bound of the bucket containing the
+ * q-th fraction of all values, but not more than the maximum
+ */
+uint32_t LogHistogram::percentile(float q) const
+{
+  if (_count == 0) return 0;
+  uint32_t rank = (uint32_t)(q * _count + 0.5f);
+  uint32_t sum  = 0;
+  for (uint8_t b = 0; b < NBR_BUCKETS; b++)
+  {
+    sum += _buckets[b];
+    if (sum >= rank && sum > 0 && b < NBR_BUCKETS - 1) return upperBound(b) < _max ? upperBound(b) : _max;
+  }
+  return _max;
+}
+
+/**
+ * Print the non-empty buckets with their range and count,
+ * followed by the median, 99th percentile and maximum
+ */
+void LogHistogram::print(const char *title, const char *unit) const
+{
+  Serial.printf("--- %s [%s] ---\n", title, unit);
+  for (uint8_t b = 0; b < NBR_BUCKETS; b++)
+  {
+    if (_buckets[b] == 0) continue;
+    Serial.printf("%8u .. %8u  %10u\n", (unsigned)(b ? 1UL << (b - 1) : 0), (unsigned)upperBound(b), (unsigned)_buckets[b]);
+  }
+  Serial.printf("count %u  p50 <= %u  p99 <= %u  max %u\n\n",
+                (unsigned)_count, (unsigned)percentile(0.5f), (unsigned)percentile(0.99f), (unsigned)_max);
+}
@@ -0,0 +1,44 @@
+/**
+ * Class        LogHistogram
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Histogram with logarithmic buckets for durations. Bucket 0
+ *              counts the value 0, bucket b > 0 counts the values from
+ *              2^(b-1) to 2^b - 1. Values beyond the last bucket are counted
+ *              in the last bucket. Adding a value costs O(1).
+ *
+ * Remarks      The unit of the values is up to the user, e.g. µs or ms.
+ *              The percentiles are reported as the upper bound of the bucket
+ *              in which they fall, i.e. they are never underestimated.
+ */
+#pragma once
+#include <Arduino.h>
+
+class LogHistogram
+{
+  public:
+    static constexpr uint8_t NBR_BUCKETS = 25;  // up to 2^24 - 1
+
+    void add(uint32_t value)
+    {
+      uint8_t b = value ? 32 - __builtin_clz(value) : 0;
+      _buckets[b < NBR_BUCKETS ? b : NBR_BUCKETS - 1]++;
+      _count++;
+      if (value > _max) _max = value;
+    }
+
+    void     reset();
+    uint32_t getCount() const { return _count; }
+    uint32_t getMax() const   { return _max; }
+    uint32_t getBucket(uint8_t b) const { return _buckets[b]; }
+    uint32_t percentile(float q) const;  // q = 0..1
+    void     print(const char *title, const char *unit) const;
+
+    static uint32_t upperBound(uint8_t b) { return b ? (1UL << b) - 1 : 0; }
+
+  private:
+    uint32_t _buckets[NBR_BUCKETS] = {};
+    uint32_t _count = 0;
+    uint32_t _max   = 0;
+};
@@ -0,0 +1,28 @@
+/**
+ * Class        LoopStats
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the loop latency and jitter statistics
+ *
+ * Board        ESP32 DoIt DevKit V1
+ */
+#include "LoopStats.h"
+
+/**
+ * Clear all histograms. The next iteration is measured
+ * from the next call of tick() on.
+ */
+void LoopStats::reset()
+{
+  _iteration.reset();
+  _lateness.reset();
+  _actuation.reset();
+  _hasTick = false;
+}
+
+void LoopStats::print()
+{
+  _iteration.print("Loop iteration", "us");
+  _lateness.print("Refresh lateness", "ms");
+  _actuation.print("Sense to actuate", "us");
+}
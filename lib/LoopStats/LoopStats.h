@@ -0,0 +1,48 @@
+/**
+ * Class        LoopStats
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Collects the duration of the main loop iterations in µs and
+ *              the lateness of the thermostat refresh in ms in two
+ *              logarithmic histograms. A third histogram holds the latency
+ *              in µs from sampling the sensor to switching the output.
+ *
+ *              void loop()
+ *              {
+ *                loopStats.tick(micros());
+ *                ...
+ *              }
+ *
+ * Remarks      The iteration duration is the time between two successive
+ *              calls of tick(), so it includes everything running outside
+ *              of loop() as well.
+ */
+#pragma once
+#include "LogHistogram.h"
+
+class LoopStats
+{
+  public:
+    void tick(uint32_t usNow)
+    {
+      if (_hasTick) _iteration.add(usNow - _usLast);
+      _usLast  = usNow;
+      _hasTick = true;
+    }
+
+    void recordLateness(uint32_t msLate) { _lateness.add(msLate); }
+    void recordActuation(uint32_t usLatency) { _actuation.add(usLatency); }
+    void reset();
+    void print();
+    const LogHistogram& getIteration() const { return _iteration; }
+    const LogHistogram& getLateness() const  { return _lateness; }
+    const LogHistogram& getActuation() const { return _actuation; }
+
+  private:
+    LogHistogram _iteration;  // µs
+    LogHistogram _lateness;   // ms
+    LogHistogram _actuation;  // µs
+    uint32_t     _usLast  = 0;
+    bool         _hasTick = false;
+};
@@ -0,0 +1,79 @@
+/**
+ * Class        MemStats
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the heap and stack usage report
+ *
+ * Board        ESP32 DoIt DevKit V1
+ *
+ * Remarks      The stack high-water mark of all tasks needs the FreeRTOS
+ *              trace facility, without it only the loop task is reported.
+ *              ESP-IDF reports stack sizes in bytes.
+ */
+#include "MemStats.h"
+
+int32_t MemStats::_blocksAtSteadyState = -1;
+
+#ifdef ESP32
+
+#include <esp_heap_caps.h>
+
+static int32_t allocatedBlocks()
+{
+  multi_heap_info_t info;
+  heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+  return (int32_t)info.allocated_blocks;
+}
+
+void MemStats::markSteadyState()
+{
+  _blocksAtSteadyState = allocatedBlocks();
+}
+
+int32_t MemStats::getBlocksSinceSteadyState()
+{
+  return _blocksAtSteadyState < 0 ? 0 : allocatedBlocks() - _blocksAtSteadyState;
+}
+
+/**
+ * Print heap and stack usage to monitor
+ *
+ * free        free heap now
+ * min free    lowest free heap since boot
+ * largest     largest free block
+ * blocks      allocated blocks now and difference to the end of setup()
+ * stack       unused stack (high-water mark) per task
+ */
+void MemStats::printMemory()
+{
+  Serial.printf(R"(--- Memory ---
+Heap free      %7u bytes
+Heap min free  %7u bytes
+Largest block  %7u bytes
+Heap blocks    %7d (%+d since setup)
+)", (unsigned)ESP.getFreeHeap(), (unsigned)ESP.getMinFreeHeap(), (unsigned)ESP.getMaxAllocHeap(),
+    (int)allocatedBlocks(), (int)getBlocksSinceSteadyState());
+
+  Serial.println("--- Stack high-water mark [bytes unused] ---");
+#if configUSE_TRACE_FACILITY
+  static TaskStatus_t tasks[20];
+  UBaseType_t n = uxTaskGetSystemState(tasks, sizeof(tasks) / sizeof(tasks[0]), nullptr);
+  for (UBaseType_t i = 0; i < n; i++)
+  {
+    Serial.printf("%-16s %6u\n", tasks[i].pcTaskName, (unsigned)tasks[i].usStackHighWaterMark);
+  }
+#else
+  Serial.printf("%-16s %6u\n", pcTaskGetTaskName(nullptr), (unsigned)uxTaskGetStackHighWaterMark(nullptr));
+#endif
+  Serial.println();
+}
+
+#else
+
+#include "HeapTrack.h"
+
+void    MemStats::markSteadyState() { _blocksAtSteadyState = 0; }
+int32_t MemStats::getBlocksSinceSteadyState() { return 0; }
+void    MemStats::printMemory() { heapTrackPrint(stdout); }
+
+#endif
@@ -0,0 +1,27 @@
+/**
+ * Class        MemStats
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Reports the heap usage and the stack high-water mark of the
+ *              FreeRTOS tasks. After setup() the firmware should not allocate
+ *              any more memory, therefore the number of allocated heap blocks
+ *              is remembered with markSteadyState() at the end of setup() and
+ *              every block allocated later and not freed is reported.
+ *
+ * Remarks      On the host the allocations are counted per component by
+ *              the operator new hooks in host/HeapTrack.h instead.
+ */
+#pragma once
+#include <Arduino.h>
+
+class MemStats
+{
+  public:
+    static void    markSteadyState();
+    static int32_t getBlocksSinceSteadyState();  // heap blocks allocated after setup()
+    static void    printMemory();
+
+  private:
+    static int32_t _blocksAtSteadyState;
+};
@@ -0,0 +1,217 @@
+/**
+ * Class        MpcLaw
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the identification of the room model and
+ *              the bounded search of the model predictive control law
+ *
+ * Board        ESP32 DoIt DevKit V1
+ */
+#include "MpcLaw.h"
+#include "Profiler.h"
+#include "TokenLog.h"
+
+#define MPC_P0         100.0f   // initial covariance of the estimators
+#define MPC_MAX_TRACE  (3 * MPC_P0)   // no forgetting above, against windup without excitation
+#define MPC_ERR_WEIGHT 0.005f   // of the squared prediction error, a memory of about 200 steps
+#define MPC_MAX_A      0.999f   // a is projected below, a room always loses heat
+#define MPC_MAX_QUIET  24       // steps after a switch, later steps do not excite the model
+
+/**
+ * Averages the samples over a step, at its end the model is
+ * updated and the heater of the next step is chosen
+ */
+float MpcLaw::control(float tCelsius, float tSetpoint, uint32_t usSample)
+{
+  float msStep = 1000.0f * _p.sStep;
+  float ms     = (usSample - _usLast) / 1000.0f;
+  if (_hasLast && ms > msStep) reset();   // a gap, the steps are not contiguous
+  else if (_hasLast) _msInStep += ms;
+  _usLast  = usSample;
+  _hasLast = true;
+  _sumT   += tCelsius;
+  _nSamples++;
+  if (_msInStep >= msStep)
+  {
+    _step(_sumT / _nSamples, tSetpoint);
+    _msInStep -= msStep;
+    _sumT      = 0;
+    _nSamples  = 0;
+  }
+  return _u;
+}
+
+void MpcLaw::_step(float tStep, float tSetpoint)
+{
+  for (uint8_t i = MPC_MAX_DEAD; i > 0; i--) _uHist[i] = _uHist[i - 1];
+  _uHist[0] = _u;
+  _nQuiet   = _uHist[0] != _uHist[1] ? 0 : _nQuiet < 0xFF ? _nQuiet + 1 : _nQuiet;
+  if (_hasStep && _nValid > MPC_MAX_DEAD && _nQuiet <= MPC_MAX_QUIET) _identify(tStep);
+  _tStep   = tStep;
+  _hasStep = true;
+  if (_nValid < 0xFF) _nValid++;
+  _u = solve(tStep, tSetpoint);
+}
+
+/**
+ * One step of recursive least squares for every dead time with the 
+ * regressor (T(k-1), u(k-d), 1), then the dead time with the smallest 
+ * mean squared prediction error among the stable models is taken. While
+ * the heater stays on or off, a model without the heater (b = 0) fits as
+ * well, so the unstable ones are not taken and the models are only updated
+ * up to MPC_MAX_QUIET steps after a switch. Near the setpoint the temperature
+ * hardly changes, so a and c are not well separated and a would drift
+ * above 1, which is projected back.
+ */
+void MpcLaw::_identify(float tStep)
+{
+  float y = tStep - MPC_T_REF;
+  for (uint8_t d = 0; d <= MPC_MAX_DEAD; d++)
+  {
+    Rls  &r = _rls[d];
+    float phi[3] = { _tStep - MPC_T_REF, (float)_uHist[d], 1.0f };
+    float pPhi[3];
+    for (uint8_t i = 0; i < 3; i++) pPhi[i] = r.P[i][0] * phi[0] + r.P[i][1] * phi[1] + r.P[i][2] * phi[2];
+    float lambda = r.P[0][0] + r.P[1][1] + r.P[2][2] > MPC_MAX_TRACE ? 1.0f : _p.lambda;
+    float den    = lambda + phi[0] * pPhi[0] + phi[1] * pPhi[1] + phi[2] * pPhi[2];
+    float e      = y - (r.theta[0] * phi[0] + r.theta[1] * phi[1] + r.theta[2] * phi[2]);
+    r.err2 += MPC_ERR_WEIGHT * (e * e - r.err2);
+    for (uint8_t i = 0; i < 3; i++)
+    {
+      float k = pPhi[i] / den;
+      r.theta[i] += k * e;
+      for (uint8_t j = 0; j < 3; j++) r.P[i][j] = (r.P[i][j] - k * pPhi[j]) / lambda;
+    }
+    if (r.theta[0] > MPC_MAX_A) r.theta[0] = MPC_MAX_A;
+  }
+  for (uint8_t d = 0; d <= MPC_MAX_DEAD; d++) 
+  {
+    if (_isStable(_rls[d]) && (! _isStable(_rls[_d]) || _rls[d].err2 < _rls[_d].err2)) _d = d;
+  }
+  _nbrSteps++;
+}
+
+/**
+ * Heater of the step after the one just ended. The temperatures up to 
+ * the end of the dead time follow from the past steps, the search 
+ * starts from there. Without a model, or with a model whose steady states 
+ * with the heater off and on do not enclose the setpoint, the law switches
+ * like a hysteresis. Outside of ±MPC_GUARD_BAND the model is overruled.
+ */
+uint8_t MpcLaw::solve(float tNow, float tSetpoint)
+{
+  PROFILE_SCOPE(PRB_MPC_SOLVE);
+  if (tNow < tSetpoint - MPC_GUARD_BAND) return 1;
+  if (tNow > tSetpoint + MPC_GUARD_BAND) return 0;
+  getModel(_a, _b, _c);
+  _tSet = tSetpoint - MPC_T_REF;
+  if (! isIdentified() || _c / (1 - _a) >= _tSet || (_b + _c) / (1 - _a) <= _tSet)
+  {
+    if (tNow < tSetpoint - MPC_FALLBACK_BAND) return 1;
+    if (tNow > tSetpoint + MPC_FALLBACK_BAND) return 0;
+    return _u;
+  }
+  float t = tNow - MPC_T_REF;
+  for (uint8_t j = 1; j <= _d; j++) t = _a * t + _b * _uHist[_d - j] + _c;
+  _bestCost  = INFINITY;
+  _bestFirst = _u;
+  _nodes     = 0;
+  _search(0, t, _u, 0.0f, _u);
+  return _bestFirst;
+}
+
+/**
+ * Depth first over the heater of step i, the current state is tried first.
+ * A branch is cut when its cost reaches the best complete sequence, 
+ * the costs of the steps are never negative.
+ */
+void MpcLaw::_search(uint8_t i, float t, uint8_t uPrev, float cost, uint8_t uFirst)
+{
+  for (uint8_t n = 0; n < 2; n++)
+  {
+    uint8_t u  = n ? 1 - uPrev : uPrev;
+    float   tn = _a * t + _b * u + _c;
+    float   e  = tn - _tSet;
+    float   c  = cost + e * e + _p.wEnergy * u + (n ? _p.wSwitch : 0.0f);
+    uint8_t first = i == 0 ? u : uFirst;
+    _nodes++;
+    if (c >= _bestCost) continue;
+    if (i + 1 == MPC_HORIZON)
+    {
+      _bestCost  = c;
+      _bestFirst = first;
+    }
+    else _search(i + 1, tn, u, c, first);
+  }
+}
+
+/**
+ * Restarts the averaging of the steps, the heater is off
+ */
+void MpcLaw::reset()
+{
+  _hasLast  = false;
+  _hasStep  = false;
+  _nValid   = 0;
+  _msInStep = 0;
+  _sumT     = 0;
+  _nSamples = 0;
+  _u        = 0;
+  for (uint8_t i = 0; i <= MPC_MAX_DEAD; i++) _uHist[i] = 0;
+}
+
+void MpcLaw::forget()
+{
+  for (Rls &r : _rls) r = { { 1.0f, 0.0f, 0.0f }, { { MPC_P0, 0, 0 }, { 0, MPC_P0, 0 }, { 0, 0, MPC_P0 } }, 0.0f };
+  _d        = 0;
+  _nbrSteps = 0;
+  reset();
+}
+
+bool MpcLaw::_isStable(const Rls &r)
+{
+  return r.theta[0] > 0.0f && r.theta[0] < 1.0f && r.theta[1] > 0.0f;
+}
+
+bool MpcLaw::isIdentified()
+{
+  return _nbrSteps >= MPC_MIN_STEPS && _isStable(_rls[_d]);
+}
+
+uint8_t MpcLaw::getDeadTime()
+{
+  return _d;
+}
+
+void MpcLaw::getModel(float &a, float &b, float &c)
+{
+  a = _rls[_d].theta[0];
+  b = _rls[_d].theta[1];
+  c = _rls[_d].theta[2];
+}
+
+float MpcLaw::getModelError()
+{
+  return sqrtf(_rls[_d].err2);
+}
+
+uint32_t MpcLaw::getSteps()
+{
+  return _nbrSteps;
+}
+
+uint16_t MpcLaw::getNodes()
+{
+  return _nodes;
+}
+
+void MpcLaw::printParams()
+{
+  float a, b, c;
+  getModel(a, b, c);
+  TLOG("Step %.0f s  wEnergy %.3f  wSwitch %.3f  lambda %.3f\n", _p.sStep, _p.wEnergy, _p.wSwitch, _p.lambda);
+  TLOG("Model a %.4f  b %.3f °C  c %.3f °C  dead time %u steps  rms error %.3f °C\n", a, b, c, (unsigned)_d, getModelError());
+  if (isIdentified()) TLOG("Identified after %u steps\n", (unsigned)_nbrSteps);
+  else                TLOG("Not identified after %u steps\n", (unsigned)_nbrSteps);
+  TLOG("Last search %u model evaluations\n", (unsigned)_nodes);
+}
@@ -0,0 +1,108 @@
+/**
+ * Class        MpcLaw
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Model predictive on/off control law for the Thermostat. The
+ *              samples are averaged over model steps of sStep and the room
+ *              is identified online as first order plus dead time:
+ *
+ *              T(k+1) = a T(k) + b u(k-d) + c      u = 0 or 1
+ *
+ *              a, b and c are estimated by recursive least squares with the
+ *              forgetting factor lambda, one estimator for each dead time
+ *              d = 0..MPC_MAX_DEAD steps, and the one with the smallest
+ *              prediction error is used. At the end of every step the
+ *              heater is chosen for the next MPC_HORIZON steps after the 
+ *              dead time, so that the cost
+ *
+ *              J = sum (T - setpoint)² + wEnergy * u + wSwitch * |u - u'|
+ *
+ *              is minimal, and the first of them is applied (receding 
+ *              horizon). The search is a depth first branch and bound over
+ *              the 2^MPC_HORIZON sequences, which prunes a branch as soon
+ *              as its cost exceeds the best so far, so it takes at most 
+ *              2^(MPC_HORIZON+1) - 2 model evaluations.
+ *
+ *              MpcLaw mpc(mpcParamsRoom);
+ *              thermostat.setControlLaw(&mpc);
+ *
+ * Remarks      Until the model has been identified over MPC_MIN_STEPS steps
+ *              and is stable (0 < a < 1, b > 0), the law switches like a 
+ *              hysteresis of ±MPC_FALLBACK_BAND around the setpoint, which 
+ *              also excites the room for the identification. More than
+ *              MPC_GUARD_BAND from the setpoint the heater is forced on or 
+ *              off, whatever the model says. reset() keeps
+ *              the model and restarts the step, forget() clears the model.
+ *              The cycles of the search are measured with the probe 
+ *              PRB_MPC_SOLVE when PROFILING is defined.
+ */
+#pragma once
+#include "IControlLaw.h"
+
+#define MPC_HORIZON        8       // decisions searched
+#define MPC_MAX_DEAD       5       // steps
+#define MPC_MIN_STEPS      36      // steps before the model is used
+#define MPC_FALLBACK_BAND  0.25f   // °C
+#define MPC_GUARD_BAND     1.0f    // °C, the heater is forced on or off outside
+#define MPC_T_REF          20.0f   // °C, the model is relative to it
+
+using MpcParams = struct mpcParams
+{
+  float sStep;     // s, model step
+  float wEnergy;   // cost of a step with the heater on, °C²
+  float wSwitch;   // cost of a switch, °C²
+  float lambda;    // forgetting factor of the identification
+};
+
+// Room with a radiator, steps of 5 minutes, a memory of about 17 hours
+constexpr MpcParams mpcParamsRoom = { 300.0f, 0.02f, 0.05f, 0.995f };
+
+class MpcLaw : public IControlLaw
+{
+  public:
+    MpcLaw(const MpcParams &params = mpcParamsRoom) : _p(params) { forget(); }
+
+    float control(float tCelsius, float tSetpoint, uint32_t usSample) override;
+    void  reset() override;        // restart the step, the model is kept
+    const char* getName() override { return "MPC"; }
+    ControlLawCode getCode() override { return LAW_MPC; }
+    void  printParams() override;
+    void  forget();                // clear the identified model
+    bool  isIdentified();
+    uint8_t  getDeadTime();        // steps
+    void  getModel(float &a, float &b, float &c);   // T relative to MPC_T_REF
+    float getModelError();         // rms of the one step prediction, °C
+    uint32_t getSteps();
+    uint16_t getNodes();           // model evaluations of the last search
+    uint8_t  solve(float tNow, float tSetpoint);    // heater of the next step, 0 or 1
+
+  private:
+    using Rls = struct rls { float theta[3]; float P[3][3]; float err2; };
+
+    void _step(float tStep, float tSetpoint);
+    void _identify(float tStep);
+    static bool _isStable(const Rls &r);
+    void _search(uint8_t i, float t, uint8_t uPrev, float cost, uint8_t uFirst);
+
+    MpcParams _p;
+    Rls      _rls[MPC_MAX_DEAD + 1];
+    uint8_t  _uHist[MPC_MAX_DEAD + 1];  // heater of the last steps, [0] the step just ended
+    uint8_t  _d        = 0;     // dead time of the best estimator
+    uint8_t  _u        = 0;     // heater of the current step
+    uint32_t _nbrSteps = 0;     // identified steps
+    uint8_t  _nValid   = 0;     // steps since reset(), saturates
+    uint8_t  _nQuiet   = 0;     // steps since the last switch, saturates
+    bool     _hasLast  = false;
+    bool     _hasStep  = false; // a full step has been averaged
+    uint32_t _usLast   = 0;
+    float    _msInStep = 0;
+    float    _sumT     = 0;     // of the samples of the step
+    uint16_t _nSamples = 0;
+    float    _tStep    = 0;     // mean temperature of the last step
+    // search
+    float    _a, _b, _c, _tSet;
+    float    _bestCost;
+    uint8_t  _bestFirst;
+    uint16_t _nodes    = 0;
+};
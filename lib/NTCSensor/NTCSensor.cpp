@@ -24,13 +24,17 @@
  * Remarks
  * References   
  */ 
-#include "NTCsensor.h"
+#include "NTCSensor.h"
+#include "Profiler.h"
+#include "Trace.h"
+#include "TokenLog.h"
 
 
 /** 
  * Initializes the sensor and reads in the measurement data. 
  * If no sensor is available, the program is terminated and 
- * an error message is displayed. 
+ * an error message is displayed. The input must have settled,
+ * the application waits once for all of its sensors.
  */
 void NTCSensor::setup()
 {
@@ -38,7 +42,6 @@ void NTCSensor::setup()
     pinMode(_adc.pin, INPUT);
     analogSetAttenuation(_adc.att);
     _sData.Roo = _ntc.Ro * exp(-(double)_ntc.beta / (_sData.To - _sData.Tabs)); // calculate the resistance of the NTC for T --> oo
-    delay(1000);
     readSensor();   
     log_i("==> done");
 }
@@ -46,11 +49,51 @@ void NTCSensor::setup()
 
 /**
  * Read the sensor and calculate the temperature 
- * in Fahrenheit and in Kelvin.
+ * in Fahrenheit and in Kelvin. The reading is
+ * classified by the fault detector and, if good,
+ * added to the noise estimate.
  */
 void NTCSensor::readSensor()
 {
-    _sData.analogValue = analogRead(_adc.pin);
+    PROFILE_SCOPE(PRB_READ_SENSOR);
+    sample();
+    convert();
+    SensorFault fault = _detector.check(_sData.analogValue, _adc.Amax, _sData.tCelsius, _sData.usSample);
+    if (fault != _fault && fault)  log_w("pin %d sensor fault %s", _adc.pin, FaultDetector::faultName(fault));
+    if (fault != _fault && !fault) log_i("pin %d sensor recovered", _adc.pin);
+    _fault = fault;
+    if (fault) _noise.skip();
+    else       _noise.add(_adc.att, _sData.analogValue);
+}
+
+
+/**
+ * Take the analog value, either with analogRead() or 
+ * from the slot of the last frame of the attached scan
+ */
+void NTCSensor::sample()
+{
+    TRACE_SCOPE(TRC_SAMPLE);
+    _sData.seq++;
+    if (_scan)
+    {
+        _sData.usSample = _scan->getFrameTime();
+        _sData.analogValue = _scan->getCode(_slot);
+    }
+    else
+    {
+        _sData.usSample = micros();
+        _sData.analogValue = analogRead(_adc.pin);
+    }
+}
+
+
+/**
+ * Calculate voltage, resistance and temperature from the analog value
+ */
+void NTCSensor::convert()
+{
+    TRACE_SCOPE(TRC_CONVERT);
     _sData.v = (_adc.Vref - _adc.Voff) / (double)_adc.Amax;
     _sData.vin = (_sData.analogValue * _sData.v) + _adc.Voff;
     _sData.k = _sData.vin / ( _adc.Vcc - _sData.vin);
@@ -62,6 +105,23 @@ void NTCSensor::readSensor()
 }
 
 
+/**
+ * Read the analog value from the frame of the scan, 
+ * the sensors pin must be one of the scanned pins
+ */
+void NTCSensor::attachScan(AdcScan &scan)
+{
+    _slot = scan.getSlot(_adc.pin);
+    _scan = _slot < ADCSCAN_MAX_CHANNELS ? &scan : nullptr;
+    if (! _scan) log_w("pin %d is not scanned", _adc.pin);
+}
+
+void NTCSensor::detachScan()
+{
+    _scan = nullptr;
+}
+
+
 /**
  * Returns temperature in °C
  * To be called after a readSensor()
@@ -81,6 +141,47 @@ SensorData&  NTCSensor::getDataReference()
 }
 
 
+SensorFault NTCSensor::getFault()
+{
+    return _fault;
+}
+
+FaultDetector& NTCSensor::getFaultDetector()
+{
+    return _detector;
+}
+
+NoiseStats& NTCSensor::getNoise()
+{
+    return _noise;
+}
+
+float NTCSensor::getNoiseSigma()
+{
+    return _noise.getSigma(_adc.att);
+}
+
+/**
+ * The noise in LSB times the slope of the temperature at the last 
+ * reading. With T = beta / ln(Rt/Roo) the slope is T² / beta times 
+ * the relative change of Rt per LSB, which is the same whether the 
+ * NTC is connected to GND or to Vcc.
+ */
+float NTCSensor::getNoiseCelsius()
+{
+    double vRest = _adc.Vcc - _sData.vin;
+    if (_sData.vin <= 0 || vRest <= 0) return 0;
+    double t = _sData.tKelvin;
+    double perLsb = t * t / _ntc.beta * _sData.v * _adc.Vcc / (_sData.vin * vRest);
+    return getNoiseSigma() * perLsb;
+}
+
+float NTCSensor::getEnob()
+{
+    return _noise.getEnob(_adc.att, _adc.Amax);
+}
+
+
 void NTCSensor::setNTCbeta(uint16_t beta)
 {
     _ntc.beta = beta;
@@ -101,7 +202,8 @@ void NTCSensor::setNTCbeta(uint16_t beta)
  */
 void NTCSensor::printParams()
 {
-  Serial.printf(R"(--- NTC Parameters ---
+  PROFILE_SCOPE(PRB_PRINT_PARAMS);
+  TLOG(R"(--- NTC Parameters ---
 beta        %d
 Ro         %d
 Rs         %d
@@ -111,14 +213,38 @@ Tabs     %7.2f °C
 --- ADC Parameters ---
 Pin         %d
 Analog Max  %d
-NTC to      %s
-Vcc        %5.0f mV
+)",
+_ntc.beta, _ntc.Ro, _ntc.Rs, _sData.Roo, _sData.To, _sData.Tabs, _adc.pin, _adc.Amax);
+  if (_adc.ntcToGround) TLOG("NTC to      GND\n");
+  else                  TLOG("NTC to      Vcc\n");
+  TLOG(R"(Vcc        %5.0f mV
 Vref       %5.0f mV
 Voff       %5.0f mV
 
-)",
-_ntc.beta, _ntc.Ro, _ntc.Rs, _sData.Roo, _sData.To, _sData.Tabs, 
-_adc.pin, _adc.Amax, _adc.ntcToGround ? "GND" : "Vcc", _adc.Vcc, _adc.Vref, _adc.Voff );
+)", _adc.Vcc, _adc.Vref, _adc.Voff);
+}
+
+/**
+ * Print the noise of the analog values and the effective 
+ * number of bits for every attenuation used so far
+ *
+ * Samples      differences of successive codes in the estimate
+ * Sigma        standard deviation of the noise in LSB and mV
+ * ENOB         effective number of bits
+ */
+void NTCSensor::printNoise()
+{
+  double mvPerLsb = (_adc.Vref - _adc.Voff) / (double)_adc.Amax;
+  Serial.printf("--- ADC Noise pin %d ---\n", _adc.pin);
+  Serial.printf("Attenuation  Samples  Sigma LSB  Sigma mV   ENOB\n");
+  for (uint8_t a = 0; a < NOISE_NBR_ATT; a++)
+  {
+    adc_attenuation_t att = (adc_attenuation_t)a;
+    if (_noise.getCount(att) == 0) continue;
+    Serial.printf("%-11s %8u %10.2f %9.2f %6.2f\n", NoiseStats::attName(att), (unsigned)_noise.getCount(att),
+                  _noise.getSigma(att), _noise.getSigma(att) * mvPerLsb, _noise.getEnob(att, _adc.Amax));
+  }
+  Serial.println();
 }
 
 /**
@@ -132,8 +258,9 @@ _adc.pin, _adc.Amax, _adc.ntcToGround ? "GND" : "Vcc", _adc.Vcc, _adc.Vref, _adc
  */
 void NTCSensor::printData()
 {
+  PROFILE_SCOPE(PRB_PRINT_DATA);
   readSensor();
-  Serial.printf(R"(--- Sensor Values ---
+  TLOG(R"(--- Sensor Values ---
 Analog Value %d
 v        %7.5f
 Vin      %7.0f mV
@@ -146,3 +273,50 @@ Tk         %5.1f °K
 )", _sData.analogValue, _sData.v, _sData.vin, _sData.k, _sData.Rt, 
     _sData.tCelsius, _sData.tFahrenheit, _sData.tKelvin);
 }
+
+/**
+ * Print the parameters which have changed since the last report.
+ * A keyframe prints all of them, laid out as printParams() does.
+ */
+void NTCSensor::reportParams(ChangeReport &report)
+{
+  PROFILE_SCOPE(PRB_PRINT_PARAMS);
+  bool kf = report.isKeyframe();
+  if (kf) TLOG("--- NTC Parameters ---\n");
+  if (report.changed(RF_BETA, _ntc.beta, 1))  TLOG("beta        %d\n", _ntc.beta);
+  if (report.changed(RF_RO, _ntc.Ro, 1))      TLOG("Ro         %d\n", _ntc.Ro);
+  if (report.changed(RF_RS, _ntc.Rs, 1))      TLOG("Rs         %d\n", _ntc.Rs);
+  if (report.changed(RF_ROO, _sData.Roo, 1e-5)) TLOG("Roo      %7.5f\n", _sData.Roo);
+  if (kf) TLOG("To       %7.2f °C\nTabs     %7.2f °C\n--- ADC Parameters ---\n", _sData.To, _sData.Tabs);
+  if (report.changed(RF_PIN, _adc.pin, 1))    TLOG("Pin         %d\n", _adc.pin);
+  if (report.changed(RF_AMAX, _adc.Amax, 1))  TLOG("Analog Max  %d\n", _adc.Amax);
+  if (report.changed(RF_NTC_TO, _adc.ntcToGround, 1))
+  {
+    if (_adc.ntcToGround) TLOG("NTC to      GND\n");
+    else                  TLOG("NTC to      Vcc\n");
+  }
+  if (report.changed(RF_VCC, _adc.Vcc, 1))    TLOG("Vcc        %5.0f mV\n", _adc.Vcc);
+  if (report.changed(RF_VREF, _adc.Vref, 1))  TLOG("Vref       %5.0f mV\n", _adc.Vref);
+  if (report.changed(RF_VOFF, _adc.Voff, 1))  TLOG("Voff       %5.0f mV\n", _adc.Voff);
+  if (kf) TLOG("\n");
+}
+
+/**
+ * Print the values of the last reading which have changed at the
+ * printed resolution since the last report. Does not read the sensor.
+ */
+void NTCSensor::reportData(ChangeReport &report)
+{
+  PROFILE_SCOPE(PRB_PRINT_DATA);
+  bool kf = report.isKeyframe();
+  if (kf) TLOG("--- Sensor Values ---\n");
+  if (report.changed(RF_AVAL, _sData.analogValue, 1)) TLOG("Analog Value %d\n", _sData.analogValue);
+  if (report.changed(RF_V, _sData.v, 1e-5))           TLOG("v        %7.5f\n", _sData.v);
+  if (report.changed(RF_VIN, _sData.vin, 1))          TLOG("Vin      %7.0f mV\n", _sData.vin);
+  if (report.changed(RF_K, _sData.k, 1e-5))           TLOG("k        %7.5f\n", _sData.k);
+  if (report.changed(RF_RT, _sData.Rt, 1))            TLOG("Rt         %5.0f\n", _sData.Rt);
+  if (report.changed(RF_TC, _sData.tCelsius, 0.1))    TLOG("Tc         %5.1f °C\n", _sData.tCelsius);
+  if (report.changed(RF_TF, _sData.tFahrenheit, 0.1)) TLOG("Tf         %5.1f °F\n", _sData.tFahrenheit);
+  if (report.changed(RF_TK, _sData.tKelvin, 0.1))     TLOG("Tk         %5.1f °K\n", _sData.tKelvin);
+  if (kf) TLOG("\n");
+}
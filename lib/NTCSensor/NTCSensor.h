@@ -11,6 +11,10 @@
 #include <Arduino.h>
 #include "SensorData.h"
 #include "ISensor.h"
+#include "ChangeReport.h"
+#include "AdcScan.h"
+#include "FaultDetector.h"
+#include "NoiseStats.h"
 
 
 using ParamsNTC = struct parmsNtc { uint16_t Rs; uint16_t Ro; uint16_t beta; };
@@ -30,14 +34,32 @@ class NTCSensor : public ISensor
 
     void  setup() override;
     void  readSensor() override;  // read the sensor and update the measured values
+    void  sample();               // take the analog value, from the ADC scan if attached
+    void  convert();              // calculate the measured values from the analog value
+    void  attachScan(AdcScan &scan);  // read the analog value from the scan frame
+    void  detachScan();               // read the analog value with analogRead()
     float getCelsius() override;  // return the temperature in °C
     void  printData()  override;   // print the measured values
     void  printParams(); // print the sensors parameters
+    void  printNoise();  // print the noise estimate of the analog values
+    void  reportParams(ChangeReport &report);  // print the changed parameters
+    void  reportData(ChangeReport &report);    // print the changed values of the last reading
     void  setNTCbeta(uint16_t beta);
     SensorData& getDataReference() override;
+    SensorFault getFault() override;      // fault of the last reading
+    FaultDetector& getFaultDetector();
+    NoiseStats& getNoise();
+    float getNoiseSigma();   // noise of the analog value in LSB at the current attenuation
+    float getNoiseCelsius(); // the same noise in °C at the current temperature
+    float getEnob();         // effective number of bits at the current attenuation
 
   private:
     ParamsNTC&  _ntc;
     ParamsADC&  _adc;
     SensorData& _sData;      
+    AdcScan*    _scan = nullptr;
+    FaultDetector _detector;
+    SensorFault _fault = FAULT_NONE;
+    NoiseStats  _noise;
+    uint8_t     _slot = 0;
 };
@@ -17,6 +17,8 @@ using SensorData = struct sDat
     double   Rt;            // calculated resistance at temperature T
     uint16_t analogValue;   // measured analog value Aval
     uint8_t  sensorPin;
+    uint32_t usSample;      // micros() when the analog value was sampled
+    uint32_t seq;           // sequence number of the sample
     const double  To   = 25.0;    // nominal temperature
     const double  Tabs = -273.15; // absolute temperature 
 };
\ No newline at end of file
@@ -0,0 +1,46 @@
+/**
+ * Class        NoiseStats
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the evaluation of the noise estimate
+ *
+ * Board        ESP32 DoIt DevKit V1
+ */
+#include "NoiseStats.h"
+
+void NoiseStats::reset()
+{
+  for (Welford &w : _w) w = {};
+  _hasLast = false;
+}
+
+uint32_t NoiseStats::getCount(adc_attenuation_t att)
+{
+  return att < NOISE_NBR_ATT ? _w[att].n : 0;
+}
+
+/**
+ * Standard deviation of the white noise in LSB, 
+ * the differences have twice its variance
+ */
+float NoiseStats::getSigma(adc_attenuation_t att)
+{
+  return att < NOISE_NBR_ATT ? sqrtf(_w[att].var / 2.0f) : 0;
+}
+
+/**
+ * Effective number of bits, a noise below the quantization 
+ * noise of 1/sqrt(12) LSB gives the full resolution
+ */
+float NoiseStats::getEnob(adc_attenuation_t att, uint16_t analogMax)
+{
+  float bits  = log2f(analogMax + 1.0f);
+  float sigma = getSigma(att) * sqrtf(12.0f);
+  return sigma > 1.0f ? bits - log2f(sigma) : bits;
+}
+
+const char* NoiseStats::attName(adc_attenuation_t att)
+{
+  static const char * const names[] = { "0 dB", "2.5 dB", "6 dB", "11 dB" };
+  return att < NOISE_NBR_ATT ? names[att] : "?";
+}
@@ -0,0 +1,62 @@
+/**
+ * Class        NoiseStats
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Running estimate of the noise of the raw ADC codes of one
+ *              channel, kept separately for each attenuation. The samples
+ *              are high-passed by taking the difference of successive codes,
+ *              which removes the slow change of the room temperature. The
+ *              variance of the differences is updated with Welford's
+ *              recurrence and is twice the variance of the white noise:
+ *
+ *              sigma = sqrt(var(x[n] - x[n-1]) / 2)       [LSB]
+ *              ENOB  = bits - log2(sigma * sqrt(12))
+ *
+ *              _noise.add(_adc.att, _sData.analogValue);
+ *
+ * Remarks      After NOISE_WINDOW samples the count is no longer increased,
+ *              so the estimate becomes an exponential average which follows
+ *              changes in the field. skip() breaks the chain of differences,
+ *              e.g. after a faulty sample. The noise of an ideal converter,
+ *              the quantization noise of 1/sqrt(12) LSB, gives ENOB = bits.
+ */
+#pragma once
+#include <Arduino.h>
+
+#define NOISE_NBR_ATT  4        // ADC_0db .. ADC_11db
+#define NOISE_WINDOW   4096     // samples
+
+class NoiseStats
+{
+  public:
+    void add(adc_attenuation_t att, uint16_t code)
+    {
+      if (_hasLast && att < NOISE_NBR_ATT)
+      {
+        Welford &w = _w[att];
+        float d = (float)code - (float)_lastCode;
+        if (w.n < NOISE_WINDOW) w.n++;
+        float a     = 1.0f / w.n;
+        float delta = d - w.mean;
+        w.mean += a * delta;
+        w.var   = (1.0f - a) * (w.var + a * delta * delta);
+      }
+      _lastCode = code;
+      _hasLast  = true;
+    }
+
+    void     skip() { _hasLast = false; }
+    void     reset();
+    uint32_t getCount(adc_attenuation_t att);    // differences in the estimate
+    float    getSigma(adc_attenuation_t att);    // LSB
+    float    getEnob(adc_attenuation_t att, uint16_t analogMax);
+    static const char* attName(adc_attenuation_t att);
+
+  private:
+    using Welford = struct welford { uint32_t n; float mean; float var; };
+
+    Welford  _w[NOISE_NBR_ATT] = {};
+    uint16_t _lastCode = 0;
+    bool     _hasLast  = false;
+};
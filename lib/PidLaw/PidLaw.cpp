@@ -0,0 +1,100 @@
+/**
+ * Class        PidLaw
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the fixed point PID control law
+ *
+ * Board        ESP32 DoIt DevKit V1
+ */
+#include "PidLaw.h"
+#include <Preferences.h>
+#include "TokenLog.h"
+
+#define PID_MAX_ERROR  (64L << 16)   // Q16 °C
+#define PID_MAX_DT     (60L << 16)   // Q16 s
+
+static inline int32_t toQ16(float x) { return (int32_t)lroundf(x * 65536.0f); }
+static inline int32_t clamp(int32_t x, int32_t lo, int32_t hi) { return x < lo ? lo : x > hi ? hi : x; }
+
+float PidLaw::control(float tCelsius, float tSetpoint, uint32_t usSample)
+{
+  int32_t t = toQ16(tCelsius);
+  int32_t e = clamp(toQ16(tSetpoint) - t, -PID_MAX_ERROR, PID_MAX_ERROR);
+  int32_t dt = (int32_t)(((uint64_t)(usSample - _usLast) << 16) / 1000000);
+  bool hasDt = _hasLast && dt > 0 && dt <= PID_MAX_DT;
+
+  if (hasDt)
+  {
+    // derivative on measurement, low-pass filtered with alpha = dt / (tf + dt)
+    int32_t dT    = clamp(t - _tLast, -PID_MAX_ERROR, PID_MAX_ERROR);
+    int64_t dRaw  = -((int64_t)_kd * dT) / dt;
+    dRaw = dRaw < -16 * ONE ? -16 * ONE : dRaw > 16 * ONE ? 16 * ONE : dRaw;
+    int32_t alpha = (int32_t)(((int64_t)dt << 16) / (_tf + dt));
+    _d += (int32_t)(((int64_t)alpha * (dRaw - _d)) >> 16);
+  }
+  else if (dt != 0) _d = 0;                    // first sample or gap, not a repeated sample
+  _tLast   = t;
+  _usLast  = usSample;
+  _hasLast = true;
+
+  int32_t p = (int32_t)(((int64_t)_kp * e) >> 16);
+  int32_t u = p + (int32_t)(_i >> 16) + _d;
+
+  // integrate unless saturated in the direction of the error
+  if (hasDt && ! (u >= ONE && e > 0) && ! (u <= 0 && e < 0))
+  {
+    int64_t ke = ((int64_t)_ki * e) >> 16;     // Q24
+    _i += (ke * dt) >> 8;                        // Q32
+    if (_i < 0) _i = 0;
+    if (_i > ((int64_t)ONE << 16)) _i = (int64_t)ONE << 16;
+    u = p + (int32_t)(_i >> 16) + _d;
+  }
+  return clamp(u, 0, ONE) / 65536.0f;
+}
+
+void PidLaw::reset()
+{
+  _i = 0;
+  _d = 0;
+  _hasLast = false;
+}
+
+void PidLaw::setParams(const PidParams &params)
+{
+  _params = params;
+  _kp = toQ16(params.kp);
+  _ki = (int32_t)lroundf(params.ki * 16777216.0f);
+  _kd = toQ16(params.kd);
+  _tf = toQ16(params.tf);
+}
+
+PidParams PidLaw::getParams()
+{
+  return _params;
+}
+
+bool PidLaw::save(const char *key)
+{
+  Preferences prefs;
+  if (! prefs.begin("pid")) return false;
+  bool ok = prefs.putBytes(key, &_params, sizeof(_params)) == sizeof(_params);
+  prefs.end();
+  return ok;
+}
+
+bool PidLaw::load(const char *key)
+{
+  Preferences prefs;
+  PidParams params;
+  if (! prefs.begin("pid", true)) return false;
+  bool ok = prefs.getBytes(key, &params, sizeof(params)) == sizeof(params);
+  prefs.end();
+  if (ok) setParams(params);
+  return ok;
+}
+
+void PidLaw::printParams()
+{
+  TLOG("Kp %.3f /°C  Ki %.6f /°Cs  Kd %.1f s/°C  Tf %.0f s  I %.3f  D %.3f\n", _params.kp, _params.ki,
+       _params.kd, _params.tf, (float)(_i / 4294967296.0), _d / 65536.0f);
+}
@@ -0,0 +1,71 @@
+/**
+ * Class        PidLaw
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      PID control law in fixed point for the Thermostat:
+ *
+ *              u = kp * e + ki * ∫e dt - kd * dT/dt       e = setpoint - T
+ *
+ *              - the derivative acts on the measurement, not on the error,
+ *                so a change of the limits does not kick the output
+ *              - the derivative is low-pass filtered with the time constant
+ *                tf, it would otherwise amplify the steps of the ADC
+ *              - anti-windup: the integral is held while the output is
+ *                saturated in the direction of the error and is clamped
+ *                to the output range 0..1
+ *
+ *              PidLaw pid(pidParamsOilRadiator);
+ *              thermostat.setControlLaw(&pid);
+ *
+ * Remarks      Temperatures, time and output are Q16.16, ki is Q8.24 and the
+ *              integral Q32.32, so the law runs without floating point on
+ *              targets without FPU. The error is clamped to ±64 °C and the
+ *              sample interval to 60 s, after a longer gap the derivative
+ *              restarts. The setpoint of the Thermostat is the middle of
+ *              its limits. save() and load() keep the parameters in the 
+ *              Preferences (NVS) under namespace "pid".
+ */
+#pragma once
+#include "IControlLaw.h"
+
+using PidParams = struct pidParams
+{
+  float kp;     // 1/°C
+  float ki;     // 1/(°C s)
+  float kd;     // s/°C
+  float tf;     // s, filter of the derivative
+};
+
+// Room of about 50 m3 with an oil radiator of 2 kW, see sim/Plant.h
+constexpr PidParams pidParamsOilRadiator = { 0.8f, 0.0002f, 600.0f, 60.0f };
+
+class PidLaw : public IControlLaw
+{
+  public:
+    PidLaw(const PidParams &params = pidParamsOilRadiator) { setParams(params); }
+
+    float control(float tCelsius, float tSetpoint, uint32_t usSample) override;
+    void  reset() override;
+    const char* getName() override { return "PID"; }
+    ControlLawCode getCode() override { return LAW_PID; }
+    void  printParams() override;
+    void  setParams(const PidParams &params);
+    PidParams getParams();
+    bool  save(const char *key);   // store the parameters in the Preferences
+    bool  load(const char *key);   // set the stored parameters, false if there are none
+
+  private:
+    static constexpr int32_t ONE = 1L << 16;   // 1.0 in Q16
+
+    PidParams _params;
+    int32_t  _kp;            // Q16
+    int32_t  _ki;            // Q24
+    int32_t  _kd;            // Q16
+    int32_t  _tf;            // Q16 s
+    int64_t  _i       = 0;   // Q32
+    int32_t  _d       = 0;   // Q16
+    int32_t  _tLast   = 0;   // Q16 °C
+    uint32_t _usLast  = 0;
+    bool     _hasLast = false;
+};
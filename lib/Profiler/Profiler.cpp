@@ -0,0 +1,71 @@
+/**
+ * Class        Profiler
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the cycle count statistics of the scoped probes
+ *
+ * Board        ESP32 DoIt DevKit V1
+ *
+ * Remarks      Compiles to nothing when PROFILING is not defined
+ */
+#include "Profiler.h"
+
+#ifdef PROFILING
+
+static const char * const probeNames[PRB_COUNT] =
+{
+  "readSensor",
+  "Thermostat::loop",
+  "doMenu",
+  "printParams",
+  "printData",
+  "printSettings",
+  "heartbeat",
+  "ZoneManager::loop",
+  "AdcScan::scan",
+  "Coordinator::tick",
+  "MpcLaw::solve",
+};
+
+ProbeStats Profiler::_stats[PRB_COUNT];
+
+void Profiler::record(ProbeId id, uint32_t cycles)
+{
+  ProbeStats &s = _stats[id];
+  if (s.count == 0 || cycles < s.min) s.min = cycles;
+  if (cycles > s.max) s.max = cycles;
+  s.sum += cycles;
+  s.count++;
+}
+
+void Profiler::reset()
+{
+  memset(_stats, 0, sizeof(_stats));
+}
+
+const ProbeStats& Profiler::getStats(ProbeId id)
+{
+  return _stats[id];
+}
+
+/**
+ * Print the table of probes to monitor
+ *
+ * count   number of times the probe was passed
+ * min     minimum of cycles spent in the probed block
+ * mean    mean of cycles
+ * max     maximum of cycles
+ */
+void Profiler::printProfile()
+{
+  Serial.printf("--- Profile [cycles] ---\n%-18s %10s %10s %10s %10s\n", "probe", "count", "min", "mean", "max");
+  for (int i = 0; i < PRB_COUNT; i++)
+  {
+    const ProbeStats &s = _stats[i];
+    Serial.printf("%-18s %10u %10u %10u %10u\n", probeNames[i], (unsigned)s.count, (unsigned)s.min,
+                  (unsigned)(s.count ? s.sum / s.count : 0), (unsigned)s.max);
+  }
+  Serial.println();
+}
+
+#endif
@@ -0,0 +1,98 @@
+/**
+ * Class        Profiler
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Lightweight scoped probes which count the CPU cycles spent in
+ *              a block of code. Each probe keeps the number of calls and the
+ *              minimum, mean and maximum of the cycles in a fixed table.
+ *
+ *              void NTCSensor::readSensor()
+ *              {
+ *                PROFILE_SCOPE(PRB_READ_SENSOR);
+ *                ...
+ *              }
+ *
+ * Remarks      Profiling is only compiled in when PROFILING is defined in the
+ *              build flags, otherwise PROFILE_SCOPE() expands to nothing.
+ *              The cycle counter is ESP.getCycleCount() on the ESP32 and
+ *              rdtsc or the steady clock on the host.
+ */
+#pragma once
+#include <Arduino.h>
+
+// Add new probes in front of PRB_COUNT and give them a name in Profiler.cpp
+using ProbeId = enum probeId
+{
+  PRB_READ_SENSOR,
+  PRB_THERMOSTAT_LOOP,
+  PRB_DO_MENU,
+  PRB_PRINT_PARAMS,
+  PRB_PRINT_DATA,
+  PRB_PRINT_SETTINGS,
+  PRB_HEARTBEAT,
+  PRB_ZONE_TICK,
+  PRB_ADC_SCAN,
+  PRB_COORDINATOR,
+  PRB_MPC_SOLVE,
+  PRB_COUNT
+};
+
+#if ! defined(ESP32) && (defined(__x86_64__) || defined(__i386__))
+  #include <x86intrin.h>
+#elif ! defined(ESP32)
+  #include <chrono>
+#endif
+
+/**
+ * Returns the free running cycle counter of the CPU,
+ * it wraps after 2^32 cycles (17.9 s at 240 MHz)
+ */
+inline uint32_t cycleCount()
+{
+  #if defined(ESP32)
+    return ESP.getCycleCount();
+  #elif defined(__x86_64__) || defined(__i386__)
+    return (uint32_t)__rdtsc();
+  #else
+    return (uint32_t)std::chrono::steady_clock::now().time_since_epoch().count();
+  #endif
+}
+
+#ifdef PROFILING
+
+using ProbeStats = struct probeStats { uint32_t count; uint32_t min; uint32_t max; uint64_t sum; };
+
+class Profiler
+{
+  public:
+    static inline uint32_t cycles() { return cycleCount(); }
+    static void record(ProbeId id, uint32_t cycles);
+    static void reset();
+    static void printProfile();
+    static const ProbeStats& getStats(ProbeId id);
+
+  private:
+    static ProbeStats _stats[PRB_COUNT];
+};
+
+class ProfileScope
+{
+  public:
+    ProfileScope(ProbeId id) : _id(id), _start(Profiler::cycles()) {}
+    ~ProfileScope() { Profiler::record(_id, Profiler::cycles() - _start); }
+
+  private:
+    ProbeId  _id;
+    uint32_t _start;
+};
+
+#define PROFILE_CAT(a, b)    a##b
+#define PROFILE_VAR(line)    PROFILE_CAT(_profileScope, line)
+#define PROFILE_SCOPE(id)    ProfileScope PROFILE_VAR(__LINE__)(id)
+
+#else
+
+#define PROFILE_SCOPE(id)
+
+#endif
@@ -0,0 +1,33 @@
+/**
+ * Class        SensorPublisher
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the fan-out of a sensor acquisition
+ *
+ * Board        ESP32 DoIt DevKit V1
+ */
+#include "SensorPublisher.h"
+
+bool SensorPublisher::subscribe(ISubscriber &subscriber)
+{
+  if (_nbrSubscribers >= PUBLISHER_MAX_SUBSCRIBERS) return false;
+  _subscribers[_nbrSubscribers++] = &subscriber;
+  return true;
+}
+
+void SensorPublisher::publish()
+{
+  _sensor.readSensor();
+  const SensorData &data = _sensor.getDataReference();
+  for (uint8_t i = 0; i < _nbrSubscribers; i++) _subscribers[i]->onSample(data);
+}
+
+ISensor& SensorPublisher::getSensor()
+{
+  return _sensor;
+}
+
+uint8_t SensorPublisher::getNbrSubscribers()
+{
+  return _nbrSubscribers;
+}
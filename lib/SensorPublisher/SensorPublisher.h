@@ -0,0 +1,40 @@
+/**
+ * Class        SensorPublisher
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Delivers one acquisition of a sensor to several subscribers,
+ *              e.g. a heating thermostat and a frost alarm thermostat on the
+ *              same NTC. publish() reads the sensor once and passes a 
+ *              reference to its data to every subscriber, so there are no 
+ *              extra ADC reads and no copies and all subscribers see the 
+ *              same sample sequence number.
+ *
+ *              SensorPublisher publisher(sensor);
+ *              publisher.subscribe(frostAlarm);
+ *              publisher.publish();
+ *
+ * Remarks      The subscribers are called in the order of subscription.
+ */
+#pragma once
+#include <Arduino.h>
+#include "ISensor.h"
+#include "ISubscriber.h"
+
+#define PUBLISHER_MAX_SUBSCRIBERS 8
+
+class SensorPublisher
+{
+  public:
+    SensorPublisher(ISensor &sensor) : _sensor(sensor) {}
+
+    bool     subscribe(ISubscriber &subscriber);  // false if all places are taken
+    void     publish();                           // read the sensor and deliver the sample
+    ISensor& getSensor();
+    uint8_t  getNbrSubscribers();
+
+  private:
+    ISensor     &_sensor;
+    ISubscriber *_subscribers[PUBLISHER_MAX_SUBSCRIBERS];
+    uint8_t      _nbrSubscribers = 0;
+};
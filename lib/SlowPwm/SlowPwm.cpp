@@ -0,0 +1,193 @@
+/**
+ * Class        SlowPwm
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the time-proportional output
+ *
+ * Board        ESP32 DoIt DevKit V1
+ */
+#include "SlowPwm.h"
+
+/**
+ * The duty is rounded to whole mains cycles
+ */
+void SlowPwm::setDuty(float duty)
+{
+  duty = duty < 0.0f ? 0.0f : duty > 1.0f ? 1.0f : duty;
+  _usOn = (uint32_t)lroundf(duty * (_usPeriod / _usCycle)) * _usCycle;
+}
+
+float SlowPwm::getDuty()
+{
+  return (float)_usOn / _usPeriod;
+}
+
+/**
+ * The period is rounded to whole mains cycles, call before enable()
+ */
+void SlowPwm::setPeriod(uint32_t msPeriod)
+{
+  uint32_t n = (1000UL * msPeriod + _usCycle / 2) / _usCycle;
+  _usPeriod = (n ? n : 1) * _usCycle;
+}
+
+uint32_t SlowPwm::getPeriod()
+{
+  return _usPeriod / 1000;
+}
+
+/**
+ * Delay of the first window after enable(), call before enable()
+ */
+void SlowPwm::setPhase(uint32_t msPhase)
+{
+  _usPhase = (1000UL * msPhase) % _usPeriod;
+}
+
+bool SlowPwm::isEnabled()
+{
+  return _isEnabled;
+}
+
+bool SlowPwm::isOn()
+{
+  return _isOn;
+}
+
+uint32_t SlowPwm::getWindows()
+{
+  return _nbrWindows;
+}
+
+/**
+ * Written at once, past the batch of the output, also called by the timers
+ */
+void SlowPwm::_write(bool on)
+{
+  _isOn = on;
+  _output.setNow(on);
+}
+
+#ifdef ESP32
+
+bool SlowPwm::setup()
+{
+  _isOn = false;
+  esp_timer_create_args_t window = { _onWindow, this, ESP_TIMER_TASK, "pwmWindow" };
+  esp_timer_create_args_t off    = { _onOff,    this, ESP_TIMER_TASK, "pwmOff" };
+  if (esp_timer_create(&window, &_windowTimer) != ESP_OK || esp_timer_create(&off, &_offTimer) != ESP_OK)
+  {
+    log_e("no timer");
+    return false;
+  }
+  log_i("==> period %u ms", (unsigned)(_usPeriod / 1000));
+  return true;
+}
+
+void SlowPwm::loop()
+{
+}
+
+/**
+ * The first window starts after the phase, then
+ * the window timer runs periodically
+ */
+void SlowPwm::enable()
+{
+  if (_isEnabled || ! _windowTimer) return;
+  _nbrWindows = 0;
+  _isEnabled  = true;
+  _isPeriodic = _usPhase == 0;
+  if (_isPeriodic)
+  {
+    esp_timer_start_periodic(_windowTimer, _usPeriod);
+    _startWindow();
+  }
+  else esp_timer_start_once(_windowTimer, _usPhase);
+}
+
+void SlowPwm::disable()
+{
+  if (! _isEnabled) return;
+  esp_timer_stop(_windowTimer);
+  esp_timer_stop(_offTimer);
+  _isEnabled = false;
+  _write(false);
+}
+
+void SlowPwm::_onWindow(void *arg)
+{
+  SlowPwm *pwm = (SlowPwm *)arg;
+  if (! pwm->_isPeriodic)
+  {
+    esp_timer_start_periodic(pwm->_windowTimer, pwm->_usPeriod);
+    pwm->_isPeriodic = true;
+  }
+  pwm->_startWindow();
+}
+
+void SlowPwm::_onOff(void *arg)
+{
+  ((SlowPwm *)arg)->_write(false);
+}
+
+/**
+ * Switch on and arm the off timer, runs in the esp_timer task
+ */
+void SlowPwm::_startWindow()
+{
+  uint32_t usOn = _usOn;
+  _nbrWindows++;
+  _write(usOn > 0);
+  if (usOn > 0 && usOn < _usPeriod)
+  {
+    esp_timer_stop(_offTimer);
+    esp_timer_start_once(_offTimer, usOn);
+  }
+}
+
+#else
+
+// Host: the windows are timed by polling micros() in loop()
+bool SlowPwm::setup()
+{
+  _isOn = false;
+  return true;
+}
+
+void SlowPwm::loop()
+{
+  if (! _isEnabled) return;
+  uint32_t usNow = micros();
+  if (usNow - _usWindow >= _usPeriod)
+  {
+    _usWindow += _usPeriod;
+    if (usNow - _usWindow >= _usPeriod) _usWindow = usNow;   // missed windows
+    _startWindow();
+  }
+  _write(usNow - _usWindow < _usOnWindow);
+}
+
+void SlowPwm::enable()
+{
+  if (_isEnabled) return;
+  _nbrWindows = 0;
+  _usOnWindow = 0;
+  _usWindow   = micros() + _usPhase - _usPeriod;   // the first window starts after the phase
+  _isEnabled  = true;
+  loop();
+}
+
+void SlowPwm::disable()
+{
+  _isEnabled = false;
+  _write(false);
+}
+
+void SlowPwm::_startWindow()
+{
+  _usOnWindow = _usOn;
+  _nbrWindows++;
+}
+
+#endif
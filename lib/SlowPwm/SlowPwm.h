@@ -0,0 +1,93 @@
+/**
+ * Class        SlowPwm
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Time-proportional output for a solid state relay. The heater
+ *              is switched on at the start of every window of msPeriod and
+ *              switched off after duty * msPeriod, so a control value of
+ *              0..1 sets the mean heating power while the relay switches
+ *              only once per window:
+ *
+ *              GpioOutput heater(PIN_THERMOSTAT);
+ *              SlowPwm    pwm(heater, 10000);
+ *              heater.setup();
+ *              pwm.setup();
+ *              pwm.enable();
+ *              pwm.setDuty(thermostat.getControlValue());
+ *              pwm.loop();   // every loop iteration
+ *
+ *              The on time is rounded to whole mains cycles and the period
+ *              is a multiple of the mains cycle, given in µs, 20000 for 
+ *              50 Hz and 16667 for 60 Hz. With a zero-cross SSR,
+ *              which turns on and off at the zero crossings only, every
+ *              window then contains whole cycles and no DC component.
+ *              A duty below half a cycle is off, above period minus half
+ *              a cycle is on for the whole window.
+ *
+ * Remarks      On the ESP32 the windows are timed with two esp_timers, which
+ *              switch the heater with setNow() of its IActuator, so the
+ *              edges cost no loop time and are not delayed by a blocking
+ *              loop, and the cached state of the output stays right. A
+ *              GpioOutput of a batch writes its pin at once, past the batch.
+ *              loop() does nothing there. On the host loop() times the
+ *              windows and must be called at least once per mains cycle.
+ *              The duty set during a window takes effect at the start of
+ *              the next window. The LEDC
+ *              cannot be used because its lowest frequency is far above
+ *              0.1 Hz. setPhase() shifts the windows, so that the heaters
+ *              of several zones do not switch on together.
+ */
+#pragma once
+#include <Arduino.h>
+#include "IActuator.h"
+
+#ifdef ESP32
+#include <esp_timer.h>
+#endif
+
+class SlowPwm
+{
+  public:
+    SlowPwm(IActuator &output, uint32_t msPeriod = 10000, uint32_t usMainsCycle = 20000) :
+      _output(output), _usCycle(usMainsCycle ? usMainsCycle : 20000)
+    {
+      setPeriod(msPeriod);
+    }
+
+    bool     setup();     // create the timers, the output is set up by its owner
+    void     loop();      // host: time the windows, ESP32: nothing to do
+    void     enable();    // start the windows after the phase
+    void     disable();   // stop the windows, output low
+    bool     isEnabled();
+    void     setDuty(float duty);       // 0..1
+    float    getDuty();                 // duty rounded to mains cycles
+    void     setPeriod(uint32_t msPeriod);
+    uint32_t getPeriod();               // ms
+    void     setPhase(uint32_t msPhase);
+    bool     isOn();                    // state of the window
+    uint32_t getWindows();              // windows since enable()
+
+  private:
+    void _startWindow();
+    void _write(bool on);
+
+    IActuator &_output;
+    uint32_t _usCycle;
+    uint32_t _usPeriod;
+    uint32_t _usPhase     = 0;
+    volatile uint32_t _usOn = 0;        // on time of the next window
+    volatile uint32_t _nbrWindows = 0;
+    volatile bool _isOn   = false;      // demanded by the window
+    bool     _isEnabled   = false;
+#ifdef ESP32
+    static void _onWindow(void *arg);
+    static void _onOff(void *arg);
+    esp_timer_handle_t _windowTimer = nullptr;
+    esp_timer_handle_t _offTimer    = nullptr;
+    bool     _isPeriodic  = false;
+#else
+    uint32_t _usWindow    = 0;          // start of the current window
+    uint32_t _usOnWindow  = 0;          // on time of the current window
+#endif
+};
@@ -0,0 +1,79 @@
+/**
+ * Class        SwitchCoordinator
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the queue of switch-on requests of the zones
+ *
+ * Board        ESP32 DoIt DevKit V1
+ */
+#include "SwitchCoordinator.h"
+#include "Profiler.h"
+
+/**
+ * Queue the request of a zone or update its deficit
+ * if it is already queued. Granted zones are ignored.
+ */
+void SwitchCoordinator::request(uint8_t zone, float deficit)
+{
+  if (zone >= COORD_MAX_ZONES || (_granted & (1 << zone))) return;
+  _pending |= 1 << zone;
+  _deficit[zone] = deficit;
+}
+
+void SwitchCoordinator::release(uint8_t zone)
+{
+  if (zone >= COORD_MAX_ZONES) return;
+  _pending &= ~(1 << zone);
+  _granted &= ~(1 << zone);
+}
+
+/**
+ * Grant the pending request with the largest deficit if the
+ * load limit and the spacing since the last switch on allow
+ */
+void SwitchCoordinator::tick(uint32_t msNow)
+{
+  PROFILE_SCOPE(PRB_COORDINATOR);
+  if (! _pending || getNbrGranted() >= _maxOn) return;
+  if (_hasSwitchedOn && msNow - _msLastOn < _msSpacing) return;
+
+  int8_t best = -1;
+  for (uint8_t z = 0; z < COORD_MAX_ZONES; z++)
+  {
+    if ((_pending & (1 << z)) && (best < 0 || _deficit[z] > _deficit[best])) best = z;
+  }
+  _pending &= ~(1 << best);
+  _granted |= 1 << best;
+  _msLastOn = msNow;
+  _hasSwitchedOn = true;
+}
+
+bool SwitchCoordinator::isGranted(uint8_t zone)
+{
+  return zone < COORD_MAX_ZONES && (_granted & (1 << zone));
+}
+
+bool SwitchCoordinator::isPending(uint8_t zone)
+{
+  return zone < COORD_MAX_ZONES && (_pending & (1 << zone));
+}
+
+uint8_t SwitchCoordinator::getNbrGranted()
+{
+  return __builtin_popcount(_granted);
+}
+
+uint8_t SwitchCoordinator::getNbrPending()
+{
+  return __builtin_popcount(_pending);
+}
+
+void SwitchCoordinator::setMaxOn(uint8_t maxOn)
+{
+  _maxOn = maxOn;
+}
+
+void SwitchCoordinator::setSpacing(uint32_t msSpacing)
+{
+  _msSpacing = msSpacing;
+}
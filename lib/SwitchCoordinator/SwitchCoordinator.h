@@ -0,0 +1,49 @@
+/**
+ * Class        SwitchCoordinator
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Staggers the switching on of the heaters of several zones 
+ *              which share one supply. The zones request the heating with
+ *              their distance below the lower limit. At every tick at most 
+ *              one request is granted, the one with the largest distance, 
+ *              provided that fewer than maxOn heaters are on and the last 
+ *              switch on is at least msSpacing ago. Switching off is never 
+ *              delayed and frees the load slot.
+ *
+ *              coordinator.request(z, tLimitLow - tCelsius);
+ *              coordinator.tick(millis());
+ *              if (coordinator.isGranted(z)) ... switch on
+ *              coordinator.release(z);   // after switching off
+ *
+ * Remarks      The cost of a tick is bounded by COORD_MAX_ZONES.
+ */
+#pragma once
+#include <Arduino.h>
+
+#define COORD_MAX_ZONES 8
+
+class SwitchCoordinator
+{
+  public:
+    SwitchCoordinator(uint8_t maxOn, uint32_t msSpacing) : _maxOn(maxOn), _msSpacing(msSpacing) {}
+
+    void    request(uint8_t zone, float deficit);  // zone demands heat, deficit in °C
+    void    release(uint8_t zone);                 // zone no longer heats or demands heat
+    void    tick(uint32_t msNow);                  // grant at most one pending request
+    bool    isGranted(uint8_t zone);
+    bool    isPending(uint8_t zone);
+    uint8_t getNbrGranted();
+    uint8_t getNbrPending();
+    void    setMaxOn(uint8_t maxOn);
+    void    setSpacing(uint32_t msSpacing);
+
+  private:
+    float    _deficit[COORD_MAX_ZONES];
+    uint8_t  _pending = 0;       // bit per zone
+    uint8_t  _granted = 0;       // bit per zone
+    uint8_t  _maxOn;
+    uint32_t _msSpacing;
+    uint32_t _msLastOn = 0;
+    bool     _hasSwitchedOn = false;
+};
@@ -0,0 +1,168 @@
+/**
+ * Class        SwitchPredictor
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the learning of the heat-up and coast rates
+ *              and of the lag of the room after a switch
+ *
+ * Board        ESP32 DoIt DevKit V1
+ */
+#include "SwitchPredictor.h"
+#include "TokenLog.h"
+
+#define PREDICT_MIN_RATE  1e-6f   // °C/s, about 0.004 °C/h, slower switches are not learned
+#define PREDICT_MAX_DT    600.0f  // s, after a longer gap the rate filter restarts
+#define PREDICT_MIN_SPREAD 0.01f  // variance of the rates relative to their mean square for a line with offset
+
+/**
+ * Rate filtered with alpha = dt / (sRateFilter + dt)
+ */
+void SwitchPredictor::sample(float tCelsius, uint32_t usSample)
+{
+  float dt = (usSample - _usLast) / 1e6f;
+  if (_hasLast && dt > 0 && dt <= PREDICT_MAX_DT) 
+  {
+    _rate += dt / (_sRateFilter + dt) * ((tCelsius - _tLast) / dt - _rate);
+  }
+  _usLast  = usSample;
+  _tLast   = tCelsius;
+  _hasLast = true;
+  if (_isOn ? tCelsius < _tExtreme : tCelsius > _tExtreme) _tExtreme = tCelsius;
+}
+
+/**
+ * Called after the switch has changed to on or off. The rate now is 
+ * learned as heat-up or coast rate. The extreme of the ending phase 
+ * gives the excess after the switch which started the phase.
+ */
+void SwitchPredictor::transition(bool on, float tCelsius)
+{
+  float rate = on ? -_rate : _rate;
+  if (_hasPhase && on != _isOn)
+  {
+    float excess = fabsf(_tExtreme - _tSwitch);
+    if (_rateSwitch > PREDICT_MIN_RATE)
+    {
+      if (_isOn) { _add(_fitOn,  _rateSwitch, excess, _weight); _nFitOn++; }
+      else       { _add(_fitOff, _rateSwitch, excess, _weight); _nFitOff++; }
+    }
+  }
+  if (_hasLast && rate > PREDICT_MIN_RATE)
+  {
+    if (on) _learn(_rateCool, rate, _nCool++ == 0, _weight);
+    else    _learn(_rateHeat, rate, _nHeat++ == 0, _weight);
+  }
+  _hasPhase   = true;
+  _isOn       = on;
+  _tSwitch    = _tExtreme = tCelsius;
+  _rateSwitch = rate;
+}
+
+void SwitchPredictor::_learn(float &value, float sample, bool isFirst, float weight)
+{
+  value = isFirst ? sample : value + weight * (sample - value);
+}
+
+void SwitchPredictor::_add(LagFit &fit, float x, float y, float weight)
+{
+  float f = 1.0f - weight;
+  fit = { f * fit.s1 + 1, f * fit.sx + x, f * fit.sy + y, f * fit.sxx + x * x, f * fit.sxy + x * y };
+}
+
+/**
+ * Least squares line, through the origin if the rates are too close
+ */
+void SwitchPredictor::_line(const LagFit &fit, float &slope, float &offset)
+{
+  float det = fit.s1 * fit.sxx - fit.sx * fit.sx;
+  if (det > PREDICT_MIN_SPREAD * fit.s1 * fit.sxx)
+  {
+    slope  = (fit.s1 * fit.sxy - fit.sx * fit.sy) / det;
+    offset = (fit.sy - slope * fit.sx) / fit.s1;
+  }
+  else
+  {
+    slope  = fit.sxx > 0 ? fit.sxy / fit.sxx : 0.0f;
+    offset = 0;
+  }
+}
+
+float SwitchPredictor::_predict(const LagFit &fit, float x)
+{
+  float slope, offset;
+  _line(fit, slope, offset);
+  float y = slope * x + offset;
+  return y > 0 ? y : 0.0f;
+}
+
+void SwitchPredictor::restart()
+{
+  _hasPhase = false;
+  _hasLast  = false;
+  _rate     = 0;
+}
+
+void SwitchPredictor::reset()
+{
+  restart();
+  _rateHeat = _rateCool = 0;
+  _fitOff = _fitOn = {};
+  _nHeat = _nCool = _nFitOff = _nFitOn = 0;
+}
+
+float SwitchPredictor::getOvershoot()
+{
+  float rate = _rate < 2 * _rateHeat ? _rate : 2 * _rateHeat;
+  return _nFitOff && rate > 0 ? _predict(_fitOff, rate) : 0.0f;
+}
+
+float SwitchPredictor::getUndershoot()
+{
+  float rate = -_rate < 2 * _rateCool ? -_rate : 2 * _rateCool;
+  return _nFitOn && rate > 0 ? _predict(_fitOn, rate) : 0.0f;
+}
+
+float SwitchPredictor::getRate()
+{
+  return _rate;
+}
+
+float SwitchPredictor::getRateHeat()
+{
+  return _rateHeat;
+}
+
+float SwitchPredictor::getRateCool()
+{
+  return _rateCool;
+}
+
+float SwitchPredictor::getTauOff()
+{
+  float slope, offset;
+  _line(_fitOff, slope, offset);
+  return slope;
+}
+
+float SwitchPredictor::getTauOn()
+{
+  float slope, offset;
+  _line(_fitOn, slope, offset);
+  return slope;
+}
+
+uint16_t SwitchPredictor::getCycles()
+{
+  return _nFitOff < _nFitOn ? _nFitOff : _nFitOn;
+}
+
+void SwitchPredictor::printParams()
+{
+  TLOG("Rate %.2f °C/h, learned heat-up %.2f °C/h  coast %.2f °C/h\n", _rate * 3600, _rateHeat * 3600, _rateCool * 3600);
+  float tauOff, offOff, tauOn, offOn;
+  _line(_fitOff, tauOff, offOff);
+  _line(_fitOn, tauOn, offOn);
+  TLOG("Overshoot %.0f s * rate %+.2f °C, undershoot %.0f s * rate %+.2f °C, cycles %u\n", tauOff, offOff, 
+       tauOn, offOn, (unsigned)getCycles());
+  TLOG("Predicted overshoot %.2f °C  undershoot %.2f °C\n", getOvershoot(), getUndershoot());
+}
@@ -0,0 +1,88 @@
+/**
+ * Class        SwitchPredictor
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Learns from the switching history of a thermostat how far 
+ *              the room temperature keeps moving after a switch, due to the
+ *              heat stored in the radiator and in the walls:
+ *              - the rate of the temperature is low-pass filtered with every 
+ *                sample, its value at a switch off is the heat-up rate and 
+ *                at a switch on the coast rate, in °C/s
+ *              - the overshoot after a switch off (peak - temperature at the
+ *                switch off) is fitted as a straight line over the heat-up 
+ *                rate at the switch, overshoot = tauOff * rate + offset, and
+ *                the undershoot after a switch on over the coast rate. The 
+ *                slope tauOff is the lag of the room in s, the offset is 
+ *                negative as a slow heat-up near the losses of the room
+ *                hardly overshoots.
+ *              The predicted overshoot follows the current rate, which changes
+ *              with the weather. The thermostat switches off when temperature
+ *              + overshoot reaches the upper limit and on when temperature
+ *              - undershoot reaches the lower.
+ *
+ *              SwitchPredictor predictor;
+ *              thermostat.setPredictor(&predictor);
+ *
+ * Remarks      sample() filters the rate and tracks the extreme of the current
+ *              phase, the learning is done once per transition, both in O(1).
+ *              Rates and fits are exponentially weighted over the transitions
+ *              with weight. As long as the rates at the switches hardly differ,
+ *              the line goes through the origin. The current rate is limited to twice the learned 
+ *              rate, so noise does not switch early. Until a full cycle has 
+ *              been seen, the predictions are 0 and the thermostat switches 
+ *              at the limits.
+ */
+#pragma once
+#include <Arduino.h>
+
+class SwitchPredictor
+{
+  public:
+    SwitchPredictor(float weight = 0.25f, float sRateFilter = 1800.0f) : 
+      _weight(weight), _sRateFilter(sRateFilter) 
+    {}
+
+    void  sample(float tCelsius, uint32_t usSample);  // filter the rate, track the extreme of the phase
+    void  transition(bool on, float tCelsius);        // learn from the phase just ended
+    void  restart();         // forget the current phase, e.g. after a sensor fault
+    void  reset();           // forget everything learned
+    float getOvershoot();    // °C the room would rise after a switch off now
+    float getUndershoot();   // °C the room would fall after a switch on now
+    float getRate();         // current rate, °C/s
+    float getRateHeat();     // learned heat-up rate, °C/s
+    float getRateCool();     // learned coast rate, °C/s, positive when cooling
+    float getTauOff();       // slope of the overshoot over the heat-up rate, s
+    float getTauOn();        // slope of the undershoot over the coast rate, s
+    uint16_t getCycles();    // full cycles learned from
+    void  printParams();
+
+  private:
+    // Exponentially weighted sums of the excess y over the rate x
+    using LagFit = struct lagFit { float s1, sx, sy, sxx, sxy; };
+
+    static void  _learn(float &value, float sample, bool isFirst, float weight);
+    static void  _add(LagFit &fit, float x, float y, float weight);
+    static void  _line(const LagFit &fit, float &slope, float &offset);
+    static float _predict(const LagFit &fit, float x);
+
+    float    _weight;
+    float    _sRateFilter;   // time constant of the rate filter
+    bool     _hasLast   = false;
+    uint32_t _usLast    = 0;
+    float    _tLast     = 0;
+    float    _rate      = 0;     // °C/s, filtered
+    bool     _hasPhase  = false; // a switch has been seen since the start or restart()
+    bool     _isOn      = false;
+    float    _tSwitch   = 0;     // temperature at the start of the phase
+    float    _tExtreme  = 0;     // peak of an off phase, trough of an on phase
+    float    _rateSwitch = 0;    // rate at the start of the phase
+    float    _rateHeat  = 0;
+    float    _rateCool  = 0;
+    LagFit   _fitOff    = {};    // overshoot over heat-up rate
+    LagFit   _fitOn     = {};    // undershoot over coast rate
+    uint16_t _nHeat     = 0;     // number of values learned
+    uint16_t _nCool     = 0;
+    uint16_t _nFitOff   = 0;
+    uint16_t _nFitOn    = 0;
+};
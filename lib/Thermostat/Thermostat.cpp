@@ -11,6 +11,9 @@
  * References
  */
 #include "Thermostat.h"
+#include "Profiler.h"
+#include "Trace.h"
+#include "TokenLog.h"
 
 void Thermostat::setup()
 {
@@ -19,16 +22,149 @@ void Thermostat::setup()
 
 void Thermostat::loop()
 {
-  if((millis() % _msRefresh) == 0 && _isEnabled) 
+  PROFILE_SCOPE(PRB_THERMOSTAT_LOOP);
+  uint32_t msNow = millis();
+  if(_isEnabled && (int32_t)(msNow - _msNext) >= 0) 
   {
+    _msLateness = msNow - _msNext;
+    _msNext += _msRefresh;
+    if ((int32_t)(msNow - _msNext) >= 0) _alignNext(msNow);  // missed more than one refresh
+    TRACE_BEGIN(TRC_PROCESS_DATA);
     _processData();
-    if (_sensor.getCelsius() < _tLimitLow)  { _onLowTemp();  _switchIsOn = true; };
-    if (_sensor.getCelsius() > _tLimitHigh) { _onHighTemp(); _switchIsOn = false; }
+    TRACE_END(TRC_PROCESS_DATA);
+    _usSample  = _sensor.getDataReference().usSample;
+    _seqSample = _sensor.getDataReference().seq;
+    _evaluate(_sensor.getCelsius());
   }
 }
 
+/**
+ * Evaluates a sample delivered by a SensorPublisher. The sensor
+ * has already been read, processData() is not called.
+ */
+void Thermostat::onSample(const SensorData &data)
+{
+  if (! _isEnabled) return;
+  _usSample  = data.usSample;
+  _seqSample = data.seq;
+  _evaluate(data.tCelsius);
+}
+
+/**
+ * A faulty reading keeps the switch off (fail-safe) without calling
+ * the temperature callbacks, the fault callback is called once when
+ * the fault begins. Law, predictor and band are restarted only when
+ * the fault lasts THERMOSTAT_FAULT_RESET_MS.
+ * Without a control law the switch follows the hysteresis of the
+ * limits and the control value for a time-proportional output falls
+ * linearly from 1 at the lower to 0 at the upper limit. With a control
+ * law the control value comes from the law and the switch is on above 0.5.
+ * An adaptive band replaces the limits of the hysteresis, a predictor 
+ * moves the switching points inwards by the predicted overshoot and 
+ * undershoot.
+ */
+void Thermostat::_evaluate(float tCelsius)
+{
+  TRACE_SCOPE(TRC_DECIDE);
+  if (_sensor.getFault() != FAULT_NONE) 
+  { 
+    _switchIsOn = false; 
+    if (! _isFaulty)
+    {
+      _usFault = _usSample;
+      _isFaultReset = false;
+      if (_onFault) _onFault();
+    }
+    _isFaulty = true;
+    _controlValue = 0;
+    if (! _isFaultReset && _usSample - _usFault >= 1000UL * THERMOSTAT_FAULT_RESET_MS)
+    {
+      _isFaultReset = true;
+      if (_law) _law->reset();
+      if (_predictor) _predictor->restart();
+      if (_band) _band->restart();
+    }
+    return; 
+  }
+  _isFaulty = false;
+  if (_law)
+  {
+    _controlValue = _law->control(tCelsius, (_tLimitLow + _tLimitHigh) / 2, _usSample);
+    _switchIsOn = _controlValue >= 0.5f;
+    if (_switchIsOn) { TRACE_SCOPE(TRC_ON_LOW);  _onLowTemp(); }
+    else             { TRACE_SCOPE(TRC_ON_HIGH); _onHighTemp(); }
+    return;
+  }
+  float tLow, tHigh;
+  bool  wasOn = _switchIsOn;
+  if (_band) _band->sample(tCelsius, _usSample);
+  _switchLimits(tLow, tHigh);
+  float tOn  = tLow;
+  float tOff = tHigh;
+  if (_predictor)
+  {
+    _predictor->sample(tCelsius, _usSample);
+    tOn  += _early(_predictor->getUndershoot(), tHigh - tLow);
+    tOff -= _early(_predictor->getOvershoot(), tHigh - tLow);
+  }
+  if (tCelsius < tOn)  { TRACE_SCOPE(TRC_ON_LOW);  _onLowTemp();  _switchIsOn = true; };
+  if (tCelsius > tOff) { TRACE_SCOPE(TRC_ON_HIGH); _onHighTemp(); _switchIsOn = false; }
+  if (_switchIsOn != wasOn)
+  {
+    if (_predictor) _predictor->transition(_switchIsOn, tCelsius);
+    if (_band) _band->transition(_switchIsOn, _tLimitLow, _tLimitHigh);
+  }
+  float u = (tHigh - tCelsius) / (tHigh - tLow);
+  _controlValue = u < 0.0f ? 0.0f : u > 1.0f ? 1.0f : u;
+}
+
+/**
+ * Limits of the hysteresis, those of the adaptive band if any. The
+ * bias is limited again, since the limits may have been changed since 
+ * the last adaption, so a narrower band stays within the limits and 
+ * a wider one is centred on them.
+ */
+void Thermostat::_switchLimits(float &tLow, float &tHigh)
+{
+  if (_band)
+  {
+    float delta   = _band->getDelta();
+    float maxBias = _tDelta > delta ? (_tDelta - delta) / 2 : 0;
+    float bias    = _band->getBias();
+    bias  = bias < -maxBias ? -maxBias : bias > maxBias ? maxBias : bias;
+    tLow  = (_tLimitLow + _tLimitHigh - delta) / 2 + bias;
+    tHigh = tLow + delta;
+  }
+  else
+  {
+    tLow  = _tLimitLow;
+    tHigh = _tLimitHigh;
+  }
+}
+
+/**
+ * Predicted overshoot or undershoot limited to 40 % of the delta,
+ * so the switching points stay apart
+ */
+float Thermostat::_early(float predicted, float delta)
+{
+  float maxEarly = 0.4f * delta;
+  return predicted < maxEarly ? predicted : maxEarly;
+}
+
+/**
+ * The refresh is due at the next multiple of the refresh interval.
+ * A refresh that comes too late due to a long loop iteration is not
+ * lost but executed late and its lateness is recorded.
+ */
+void Thermostat::_alignNext(uint32_t msNow)
+{
+  _msNext = msNow - msNow % _msRefresh + _msRefresh;
+}
+
 void Thermostat::enable()
 {
+  if (! _isEnabled) _alignNext(millis());
   _isEnabled = true;
 }
 
@@ -42,9 +178,78 @@ bool Thermostat::isEnabled()
   return _isEnabled;
 }
 
+bool Thermostat::isSwitchOn()
+{
+  return _switchIsOn;
+}
+
+bool Thermostat::isFaulty()
+{
+  return _isFaulty;
+}
+
+void Thermostat::setOnFault(Callback onFault)
+{
+  _onFault = &onFault;
+}
+
+/**
+ * Control law of the thermostat, nullptr for the hysteresis
+ * of the limits. The state of the law is reset.
+ */
+void Thermostat::setControlLaw(IControlLaw *law)
+{
+  _law = law;
+  if (_law) _law->reset();
+}
+
+IControlLaw* Thermostat::getControlLaw()
+{
+  return _law;
+}
+
+/**
+ * Predictor of the overshoot and undershoot for the hysteresis of 
+ * the limits, nullptr to switch at the limits. It starts a new phase.
+ */
+void Thermostat::setPredictor(SwitchPredictor *predictor)
+{
+  _predictor = predictor;
+  if (_predictor) _predictor->restart();
+}
+
+SwitchPredictor* Thermostat::getPredictor()
+{
+  return _predictor;
+}
+
+/**
+ * Band of the hysteresis adapted to a switching rate, nullptr to 
+ * switch at the limits. The band starts with the delta of the limits.
+ */
+void Thermostat::setAdaptiveBand(AdaptiveBand *band)
+{
+  _band = band;
+  if (_band) _band->begin(_tDelta);
+}
+
+AdaptiveBand* Thermostat::getAdaptiveBand()
+{
+  return _band;
+}
+
+/**
+ * Heating power demanded by the last evaluation, 0 when disabled
+ */
+float Thermostat::getControlValue()
+{
+  return _isEnabled ? _controlValue : 0.0f;
+}
+
 void Thermostat::setRefreshInterval(uint32_t msRefresh)
 {
-  _msRefresh = msRefresh;
+  _msRefresh = msRefresh > 0 ? msRefresh : 1;
+  _alignNext(millis());
 }
 
 uint32_t Thermostat::getRefreshInterval()
@@ -52,6 +257,29 @@ uint32_t Thermostat::getRefreshInterval()
   return _msRefresh;
 }
 
+/**
+ * Returns the time in µs at which the sample was taken on which the 
+ * current decision is based. Called in onLowTemp() or onHighTemp() it 
+ * allows to measure the latency from sensing to actuating.
+ */
+uint32_t Thermostat::getSampleTime()
+{
+  return _usSample;
+}
+
+uint32_t Thermostat::getSampleSeq()
+{
+  return _seqSample;
+}
+
+/**
+ * Returns by how many ms the last refresh came too late
+ */
+uint32_t Thermostat::getLateness()
+{
+  return _msLateness;
+}
+
 void Thermostat::setLimitLow(float tLow)
 {
   _tLimitLow = tLow;
@@ -86,17 +314,97 @@ float Thermostat::getTempDelta()
   return _tDelta;
 }
 
+/**
+ * One literal format per fault, since TLOG has no %s
+ */
+static void logFault(SensorFault fault)
+{
+  switch (fault)
+  {
+    case FAULT_NONE:       TLOG("Sensor fault     none\n");       break;
+    case FAULT_RAIL_LOW:   TLOG("Sensor fault     rail low\n");   break;
+    case FAULT_RAIL_HIGH:  TLOG("Sensor fault     rail high\n");  break;
+    case FAULT_NOT_FINITE: TLOG("Sensor fault     not finite\n"); break;
+    case FAULT_STUCK:      TLOG("Sensor fault     stuck\n");      break;
+    case FAULT_JUMP:       TLOG("Sensor fault     jump\n");       break;
+    case FAULT_NO_INPUT:   TLOG("Sensor fault     no input\n");   break;
+    default:               TLOG("Sensor fault     %d\n", (int)fault);
+  }
+}
 
 void Thermostat::printSettings()
 {
-  Serial.printf(R"(--- Thermostat settings ---
+  PROFILE_SCOPE(PRB_PRINT_SETTINGS);
+  TLOG(R"(--- Thermostat settings ---
 Upper limit      %6.1f °C
 Delta temp       %6.1f °C
 Lower limit      %6.1f °C
 Refresh interval %6u ms
-Thermostat is %s and switch is %s
-
-)", _tLimitHigh, _tDelta, _tLimitLow, _msRefresh, _isEnabled ? "enabled" : "disabled", _switchIsOn ? "on" : "off");
+)", _tLimitHigh, _tDelta, _tLimitLow, (unsigned)_msRefresh);
+  if (_isEnabled) TLOG("Thermostat is enabled");
+  else            TLOG("Thermostat is disabled");
+  if (_switchIsOn) TLOG(" and switch is on\n\n");
+  else             TLOG(" and switch is off\n\n");
+  if (_law) 
+  {
+    switch (_law->getCode())
+    {
+      case LAW_PID:      TLOG("Control law      PID, control value %.2f\n", _controlValue);      break;
+      case LAW_AUTOTUNE: TLOG("Control law      autotune, control value %.2f\n", _controlValue); break;
+      case LAW_MPC:      TLOG("Control law      MPC, control value %.2f\n", _controlValue);      break;
+    }
+    _law->printParams();
+    TLOG("\n");
+  }
+  else
+  {
+    float tLow, tHigh;
+    _switchLimits(tLow, tHigh);
+    if (_band)
+    {
+      TLOG("Adaptive band    %.2f..%.2f °C\n", tLow, tHigh);
+      _band->printParams();
+      TLOG("\n");
+    }
+    if (_predictor)
+    {
+      TLOG("Switching early  off at %.2f °C, on at %.2f °C\n", 
+           tHigh - _early(_predictor->getOvershoot(), tHigh - tLow), tLow + _early(_predictor->getUndershoot(), tHigh - tLow));
+      _predictor->printParams();
+      TLOG("\n");
+    }
+  }
+  if (_sensor.getFault())
+  {
+    logFault(_sensor.getFault());
+    TLOG("Heating is kept off\n\n");
+  }
 }
 
 
+
+/**
+ * Print the settings which have changed since the last report.
+ * A keyframe prints all of them, laid out as printSettings() does.
+ */
+void Thermostat::reportSettings(ChangeReport &report)
+{
+  PROFILE_SCOPE(PRB_PRINT_SETTINGS);
+  bool kf = report.isKeyframe();
+  if (kf) TLOG("--- Thermostat settings ---\n");
+  if (report.changed(RF_LIMIT_HIGH, _tLimitHigh, 0.1)) TLOG("Upper limit      %6.1f °C\n", _tLimitHigh);
+  if (report.changed(RF_DELTA, _tDelta, 0.1))          TLOG("Delta temp       %6.1f °C\n", _tDelta);
+  if (report.changed(RF_LIMIT_LOW, _tLimitLow, 0.1))   TLOG("Lower limit      %6.1f °C\n", _tLimitLow);
+  if (report.changed(RF_REFRESH, _msRefresh, 1))       TLOG("Refresh interval %6u ms\n", (unsigned)_msRefresh);
+  bool enabledChanged = report.changed(RF_ENABLED, _isEnabled, 1);
+  bool switchChanged  = report.changed(RF_SWITCH, _switchIsOn, 1);
+  if (enabledChanged || switchChanged)
+  {
+    if (_isEnabled) TLOG("Thermostat is enabled");
+    else            TLOG("Thermostat is disabled");
+    if (_switchIsOn) TLOG(" and switch is on\n");
+    else             TLOG(" and switch is off\n");
+  }
+  if (report.changed(RF_FAULT, _sensor.getFault(), 1)) logFault(_sensor.getFault());
+  if (kf) TLOG("\n");
+}
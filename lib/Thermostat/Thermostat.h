@@ -13,13 +13,39 @@
  *              SHT31, DHT11/22 or a simple NTC-Resstor. To use these sensors, you must adapt
  *              the sensor data struct in SensorData.h and provide a corresponding sensor class
  *              like BME230Sensor, SHT31Sensor, DHTSensor or NTCSensor.
+ *              Subscribed to a SensorPublisher, the thermostat evaluates every 
+ *              published sample in onSample() instead of refreshing in loop().
+ *              While the sensor reports a fault the switch is kept off, neither
+ *              onLowTemp() nor onHighTemp() is called. The optional callback
+ *              of setOnFault() is called when a fault begins, an application
+ *              which switches its heater in the callbacks switches it off there.
+ *              A fault lasting THERMOSTAT_FAULT_RESET_MS restarts the control 
+ *              law, the predictor and the band, a single faulty sample, e.g.
+ *              a jump, is only skipped, so a running autotune or the history
+ *              of the MPC survive it.
+ *              The two-point hysteresis of the limits can be replaced by a 
+ *              control law (see IControlLaw.h, PidLaw.h) with setControlLaw(),
+ *              which controls to the middle of the limits.
+ *              With a SwitchPredictor the hysteresis switches early by the 
+ *              learned overshoot and undershoot of the room, so that the 
+ *              peaks and troughs stay within the limits.
+ *              With an AdaptiveBand the hysteresis switches in a band around
+ *              the middle of the limits, whose delta is adapted to a target 
+ *              switching rate.
  */
 #pragma once
 #include "NTCSensor.h"
+#include "ISubscriber.h"
+#include "FaultDetector.h"
+#include "IControlLaw.h"
+#include "SwitchPredictor.h"
+#include "AdaptiveBand.h"
+
+#define THERMOSTAT_FAULT_RESET_MS  60000   // a fault lasting this long restarts law, predictor and band
 
 using Callback = void(&)();
 
-class Thermostat 
+class Thermostat : public ISubscriber
 {
   public:
     Thermostat(ISensor& sensor, Callback processData, Callback onLowTemp, Callback onHighTemp) : 
@@ -28,9 +54,20 @@ class Thermostat
 
     void setup();
     void loop();
+    void onSample(const SensorData &data) override;  // evaluate a published sample
     void enable();
     void disable();
     bool isEnabled();
+    bool isSwitchOn();                            // last decision, true when heating is demanded
+    bool isFaulty();                              // sensor fault at the last evaluation
+    void setOnFault(Callback onFault);            // called when a sensor fault begins
+    float getControlValue();                      // 0..1, for a time-proportional output
+    void  setControlLaw(IControlLaw *law);        // nullptr for the hysteresis of the limits
+    IControlLaw* getControlLaw();
+    void  setPredictor(SwitchPredictor *predictor);  // nullptr to switch at the limits
+    SwitchPredictor* getPredictor();
+    void  setAdaptiveBand(AdaptiveBand *band);   // nullptr to switch at the limits
+    AdaptiveBand* getAdaptiveBand();
     void setRefreshInterval(uint32_t msRefresh);  // msec
     void setLimitLow(float tLimitLow);            // °C
     void setLimitHigh(float tLimitHigh);          // °C
@@ -39,17 +76,38 @@ class Thermostat
     float getLimitHigh();
     float getTempDelta();
     uint32_t getRefreshInterval();  
+    uint32_t getLateness();         // msec
+    uint32_t getSampleTime();       // µsec
+    uint32_t getSampleSeq();        // sequence number of the sample of the last decision
     void printSettings();
+    void reportSettings(ChangeReport &report);  // print the changed settings
 
   private:
+    void _alignNext(uint32_t msNow);
+    void _evaluate(float tCelsius);
+    void  _switchLimits(float &tLow, float &tHigh);
+    float _early(float predicted, float delta);
+
     ISensor& _sensor;
     bool     _isEnabled  = false;
     bool     _switchIsOn = false;
+    bool     _isFaulty   = false;
+    bool     _isFaultReset = false;     // law, predictor and band restarted in this fault
+    uint32_t _usFault    = 0;           // sample time of the onset of the fault
+    float    _controlValue = 0;
+    IControlLaw *_law    = nullptr;
+    SwitchPredictor *_predictor = nullptr;
+    AdaptiveBand *_band  = nullptr;
     float    _tLimitLow  = 18.0;
     float    _tLimitHigh = 21.0;
     float    _tDelta     =  3.0;
     uint32_t _msRefresh  = 10000;
+    uint32_t _msNext     = 0;
+    uint32_t _msLateness = 0;
+    uint32_t _usSample   = 0;
+    uint32_t _seqSample  = 0;
     Callback _processData;;
     Callback _onLowTemp;
     Callback _onHighTemp;
+    void   (*_onFault)() = nullptr;
 };
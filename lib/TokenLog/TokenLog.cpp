@@ -0,0 +1,65 @@
+/**
+ * Class        TokenLog
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the ring buffer of the tokenized log records
+ *
+ * Board        ESP32 DoIt DevKit V1
+ *
+ * Remarks      Compiles to nothing when TOKENIZED_LOG is not defined.
+ *              When the ring is full, new records are dropped and counted,
+ *              so a record is never torn.
+ */
+#include "TokenLog.h"
+
+#ifdef TOKENIZED_LOG
+
+uint8_t  TokenLog::_ring[TOKENLOG_SIZE];
+uint16_t TokenLog::_head    = 0;
+uint16_t TokenLog::_tail    = 0;
+uint32_t TokenLog::_dropped = 0;
+
+void TokenLog::_push(const uint8_t *rec, uint16_t len)
+{
+  uint16_t used = (_head - _tail) & (TOKENLOG_SIZE - 1);
+  if (used + len >= TOKENLOG_SIZE)
+  {
+    _dropped++;
+    return;
+  }
+  for (uint16_t i = 0; i < len; i++) _ring[(_head + i) & (TOKENLOG_SIZE - 1)] = rec[i];
+  _head = (_head + len) & (TOKENLOG_SIZE - 1);
+}
+
+/**
+ * Print up to maxRecords records, each as a line of hex digits
+ * starting with '~'. Called in loop() to drain the ring bit by bit.
+ */
+void TokenLog::drain(uint8_t maxRecords)
+{
+  static const char hex[] = "0123456789abcdef";
+  char line[1 + 2 * (9 + 4 * TOKENLOG_MAX_ARGS) + 1];
+
+  while (maxRecords-- > 0 && _tail != _head)
+  {
+    uint16_t len = 9 + 4 * _ring[(_tail + 8) & (TOKENLOG_SIZE - 1)];
+    char *p = line;
+    *p++ = '~';
+    for (uint16_t i = 0; i < len; i++)
+    {
+      uint8_t b = _ring[(_tail + i) & (TOKENLOG_SIZE - 1)];
+      *p++ = hex[b >> 4];
+      *p++ = hex[b & 0x0f];
+    }
+    *p = '\0';
+    _tail = (_tail + len) & (TOKENLOG_SIZE - 1);
+    Serial.println(line);
+  }
+}
+
+uint32_t TokenLog::getDropped()
+{
+  return _dropped;
+}
+
+#endif
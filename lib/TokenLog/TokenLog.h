@@ -0,0 +1,107 @@
+/**
+ * Class        TokenLog
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Tokenized deferred logging. Instead of formatting a message
+ *              with printf, a call site stores only the token of its format
+ *              string (a 32 bit FNV-1a hash computed by the compiler) and the
+ *              raw binary arguments into a ring buffer. The ring is drained
+ *              as hex lines starting with '~'. The host tool tools/tokenlog.py
+ *              holds the table of all format strings, which it extracts from
+ *              the sources at build time, and renders the messages.
+ *
+ *              TLOG("Tc         %5.1f °C\n", _sData.tCelsius);
+ *              TLOG_I("===> switch on heating");
+ *
+ * Remarks      Tokenized logging is only compiled in when TOKENIZED_LOG is
+ *              defined in the build flags. Otherwise TLOG() is Serial.printf()
+ *              and TLOG_I() is log_i() as before.
+ *              The format must be a string literal which is not stored on the
+ *              device. Arguments must be numbers, they are stored as 32 bit
+ *              integers or floats, %s is not supported.
+ *
+ *              Record: token (4) | millis (4) | nbr of args (1) | args (4 each)
+ */
+#pragma once
+#include <Arduino.h>
+#include <type_traits>
+
+#ifdef TOKENIZED_LOG
+
+#ifndef TOKENLOG_SIZE
+  #define TOKENLOG_SIZE 1024    // bytes, must be a power of 2
+#endif
+#define TOKENLOG_MAX_ARGS 16
+
+constexpr uint32_t tokenOf(const char *s, uint32_t h = 2166136261UL)
+{
+  return *s ? tokenOf(s + 1, (h ^ (uint8_t)*s) * 16777619UL) : h;
+}
+
+class TokenLog
+{
+  public:
+    template<typename... Args>
+    static void write(uint32_t token, Args... args)
+    {
+      static_assert(sizeof...(args) <= TOKENLOG_MAX_ARGS, "too many TLOG arguments");
+      uint8_t rec[9 + 4 * sizeof...(args)];
+      uint8_t *p = rec;
+      _put32(p, token);
+      _put32(p, millis());
+      *p++ = sizeof...(args);
+      int unused[] = { 0, (_putArg(p, args), 0)... };
+      (void)unused;
+      _push(rec, sizeof(rec));
+    }
+
+    static void     drain(uint8_t maxRecords);  // print up to maxRecords records as hex lines
+    static uint32_t getDropped();               // records lost because the ring was full
+
+  private:
+    static void _put32(uint8_t *&p, uint32_t v)
+    {
+      *p++ = v; *p++ = v >> 8; *p++ = v >> 16; *p++ = v >> 24;
+    }
+
+    template<typename T>
+    static void _putArg(uint8_t *&p, T v)
+    {
+      static_assert(std::is_arithmetic<T>::value, "TLOG arguments must be numbers");
+      _putValue(p, v, std::is_floating_point<T>());
+    }
+
+    template<typename T>
+    static void _putValue(uint8_t *&p, T v, std::true_type)
+    {
+      float f = v;
+      uint32_t bits;
+      memcpy(&bits, &f, sizeof(bits));
+      _put32(p, bits);
+    }
+
+    template<typename T>
+    static void _putValue(uint8_t *&p, T v, std::false_type)
+    {
+      _put32(p, (uint32_t)v);
+    }
+
+    static void _push(const uint8_t *rec, uint16_t len);
+
+    static uint8_t  _ring[TOKENLOG_SIZE];
+    static uint16_t _head;    // next byte to write
+    static uint16_t _tail;    // next byte to read
+    static uint32_t _dropped;
+};
+
+#define TLOG_TOKEN(fmt)      std::integral_constant<uint32_t, tokenOf(fmt)>::value
+#define TLOG(fmt, ...)       TokenLog::write(TLOG_TOKEN(fmt), ##__VA_ARGS__)
+#define TLOG_I(fmt, ...)     TokenLog::write(TLOG_TOKEN("[I] " fmt "\n"), ##__VA_ARGS__)
+
+#else
+
+#define TLOG(fmt, ...)       Serial.printf(fmt, ##__VA_ARGS__)
+#define TLOG_I(fmt, ...)     log_i(fmt, ##__VA_ARGS__)
+
+#endif
@@ -0,0 +1,65 @@
+/**
+ * Class        Trace
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the ring buffer of trace events and its dump
+ *
+ * Board        ESP32 DoIt DevKit V1
+ *
+ * Remarks      Compiles to nothing when TRACING is not defined
+ */
+#include "Trace.h"
+
+#ifdef TRACING
+
+static const char * const traceNames[TRC_COUNT] =
+{
+  "loop",
+  "sample",
+  "convert",
+  "processData",
+  "decide",
+  "onLowTemp",
+  "onHighTemp",
+  "cli",
+};
+
+TraceEvent Trace::_ring[TRACE_SIZE];
+uint32_t   Trace::_head        = 0;
+bool       Trace::_isRecording = true;
+
+/**
+ * Print the recorded events from the oldest to the newest.
+ * Recording is paused while dumping.
+ *
+ * # trace mhz=240 events=512      header with the cycle frequency
+ * # name 1 sample                 names of the event ids
+ * 1234567 1 B                     cycles, event id, phase B(egin) or E(nd)
+ */
+void Trace::dump()
+{
+  _isRecording = false;
+  uint32_t n     = _head < TRACE_SIZE ? _head : TRACE_SIZE;
+  uint32_t first = _head - n;
+#ifdef ESP32
+  uint32_t mhz = getCpuFrequencyMhz();
+#else
+  uint32_t mhz = 0;   // unknown on the host, pass it to the converter
+#endif
+  Serial.printf("# trace mhz=%u events=%u\n", (unsigned)mhz, (unsigned)n);
+  for (int i = 0; i < TRC_COUNT; i++) Serial.printf("# name %d %s\n", i, traceNames[i]);
+  for (uint32_t i = first; i != _head; i++)
+  {
+    const TraceEvent &e = _ring[i & (TRACE_SIZE - 1)];
+    Serial.printf("%u %u %c\n", (unsigned)e.cycles, (unsigned)e.id, e.phase);
+  }
+  Serial.println("# end");
+  _isRecording = true;
+}
+
+void Trace::clear()
+{
+  _head = 0;
+}
+
+#endif
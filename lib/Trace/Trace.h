@@ -0,0 +1,90 @@
+/**
+ * Class        Trace
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Records begin and end events of sampling, conversion, control
+ *              decisions, callbacks and CLI handling with the cycle counter
+ *              as timestamp into a fixed ring buffer. The ring holds the last
+ *              TRACE_SIZE events and is dumped with Trace::dump() in a text
+ *              format which tools/trace2chrome.py converts to the Chrome
+ *              trace_event JSON format for a trace viewer (chrome://tracing,
+ *              ui.perfetto.dev).
+ *
+ *              TRACE_BEGIN(TRC_SAMPLE);
+ *              _sData.analogValue = analogRead(_adc.pin);
+ *              TRACE_END(TRC_SAMPLE);
+ *
+ * Remarks      Tracing is only compiled in when TRACING is defined in the
+ *              build flags, otherwise the macros expand to nothing.
+ *              Recording an event is a read of the cycle counter and an
+ *              8 byte store, it does not lock and may be left on in the field.
+ */
+#pragma once
+#include "Profiler.h"
+
+// Add new events in front of TRC_COUNT and give them a name in Trace.cpp
+using TraceId = enum traceId
+{
+  TRC_LOOP,
+  TRC_SAMPLE,
+  TRC_CONVERT,
+  TRC_PROCESS_DATA,
+  TRC_DECIDE,
+  TRC_ON_LOW,
+  TRC_ON_HIGH,
+  TRC_CLI,
+  TRC_COUNT
+};
+
+#ifdef TRACING
+
+#ifndef TRACE_SIZE
+  #define TRACE_SIZE 512    // number of events, must be a power of 2
+#endif
+
+using TraceEvent = struct traceEvent { uint32_t cycles; uint8_t id; char phase; uint16_t reserved; };
+
+class Trace
+{
+  public:
+    static inline void record(TraceId id, char phase)
+    {
+      if (! _isRecording) return;
+      TraceEvent &e = _ring[_head++ & (TRACE_SIZE - 1)];
+      e.cycles = cycleCount();
+      e.id     = id;
+      e.phase  = phase;
+    }
+    static void dump();
+    static void clear();
+
+  private:
+    static TraceEvent _ring[TRACE_SIZE];
+    static uint32_t   _head;
+    static bool       _isRecording;
+};
+
+class TraceScope
+{
+  public:
+    TraceScope(TraceId id) : _id(id) { Trace::record(_id, 'B'); }
+    ~TraceScope() { Trace::record(_id, 'E'); }
+
+  private:
+    TraceId _id;
+};
+
+#define TRACE_BEGIN(id)    Trace::record(id, 'B')
+#define TRACE_END(id)      Trace::record(id, 'E')
+#define TRACE_CAT(a, b)    a##b
+#define TRACE_VAR(line)    TRACE_CAT(_traceScope, line)
+#define TRACE_SCOPE(id)    TraceScope TRACE_VAR(__LINE__)(id)
+
+#else
+
+#define TRACE_BEGIN(id)
+#define TRACE_END(id)
+#define TRACE_SCOPE(id)
+
+#endif
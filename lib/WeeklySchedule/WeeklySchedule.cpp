@@ -0,0 +1,249 @@
+/**
+ * Class        WeeklySchedule
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the weekly schedule of the limits
+ *
+ * Board        ESP32 DoIt DevKit V1
+ */
+#include "WeeklySchedule.h"
+#include <Preferences.h>
+
+#define SCHEDULE_SECONDS_PER_WEEK  (SCHEDULE_MINUTES_PER_WEEK * 60UL)
+#define SCHEDULE_TIME_VALID        1600000000   // system time after 2020 has been set by SNTP
+
+uint32_t WeeklySchedule::_msClock    = 0;
+uint32_t WeeklySchedule::_sClock     = 0;
+bool     WeeklySchedule::_isClockSet = false;
+
+static const char * const dayNames[] = { "Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun" };
+
+/**
+ * Compile the slots into the transitions sorted by the minute of the
+ * week. A slot starting at the same minute as an earlier one replaces it.
+ */
+bool WeeklySchedule::setSlots(const ScheduleSlot *slots, uint8_t nbrSlots)
+{
+  _nbrSlots       = 0;
+  _nbrTransitions = 0;
+  _isSynced       = false;
+  if (nbrSlots > SCHEDULE_MAX_SLOTS)
+  {
+    log_w("%d slots, at most %d", nbrSlots, SCHEDULE_MAX_SLOTS);
+    return false;
+  }
+  for (uint8_t s = 0; s < nbrSlots; s++)
+  {
+    const ScheduleSlot &slot = slots[s];
+    if (slot.hour > 23 || slot.minute > 59 || slot.tLow2 >= slot.tHigh2)
+    {
+      log_w("slot %d invalid", s);
+      _nbrTransitions = 0;
+      return false;
+    }
+    for (uint8_t day = 0; day < 7; day++)
+    {
+      if (! (slot.days & (1 << day))) continue;
+      uint16_t minute = day * 1440 + slot.hour * 60 + slot.minute;
+      uint8_t i = 0;
+      while (i < _nbrTransitions && _transitions[i].minute < minute) i++;
+      if (i == _nbrTransitions || _transitions[i].minute != minute)
+      {
+        if (_nbrTransitions == SCHEDULE_MAX_TRANSITIONS)
+        {
+          log_w("more than %d transitions", SCHEDULE_MAX_TRANSITIONS);
+          _nbrTransitions = 0;
+          return false;
+        }
+        memmove(&_transitions[i + 1], &_transitions[i], (_nbrTransitions - i) * sizeof(ScheduleTransition));
+        _nbrTransitions++;
+      }
+      _transitions[i] = { minute, slot.tLow2, slot.tHigh2 };
+    }
+    _slots[s] = slot;
+  }
+  _nbrSlots = nbrSlots;
+  return true;
+}
+
+/**
+ * Once per minute of the week: stay on the active transition or advance
+ * to the next one, search only if the clock has jumped. A new transition
+ * is applied with the limit setters, the delta first, since setLimitHigh()
+ * keeps it.
+ */
+bool WeeklySchedule::loop(Thermostat &thermostat)
+{
+  if (! _isEnabled || _nbrTransitions == 0 || ! isClockSet()) return false;
+  uint16_t minute = getMinuteOfWeek();
+  if (_isSynced && minute == _minuteLast) return false;
+  _minuteLast = minute;
+
+  if (_isSynced)
+  {
+    if (_contains(_cursor, minute)) return false;
+    uint8_t next = _nextIndex(_cursor);
+    _cursor = _contains(next, minute) ? next : _seek(minute);
+  }
+  else _cursor = _seek(minute);
+  _isSynced = true;
+
+  const ScheduleTransition &t = _transitions[_cursor];
+  thermostat.setTempDelta((t.tHigh2 - t.tLow2) / 2.0f);
+  thermostat.setLimitHigh(t.tHigh2 / 2.0f);
+  return true;
+}
+
+void WeeklySchedule::enable()
+{
+  _isEnabled = true;
+  _isSynced  = false;
+}
+
+void WeeklySchedule::disable()
+{
+  _isEnabled = false;
+}
+
+bool WeeklySchedule::isEnabled()
+{
+  return _isEnabled;
+}
+
+uint8_t WeeklySchedule::getNbrTransitions()
+{
+  return _nbrTransitions;
+}
+
+const ScheduleTransition& WeeklySchedule::getActive()
+{
+  return _transitions[_cursor];
+}
+
+const ScheduleTransition& WeeklySchedule::getNext()
+{
+  return _transitions[_nextIndex(_cursor)];
+}
+
+uint16_t WeeklySchedule::getMinutesToNext()
+{
+  if (_nbrTransitions == 0) return 0;
+  uint16_t minutes = (getNext().minute + SCHEDULE_MINUTES_PER_WEEK - _minuteLast) % SCHEDULE_MINUTES_PER_WEEK;
+  return minutes == 0 ? SCHEDULE_MINUTES_PER_WEEK : minutes;
+}
+
+uint8_t WeeklySchedule::_nextIndex(uint8_t i)
+{
+  return i + 1 < _nbrTransitions ? i + 1 : 0;
+}
+
+/**
+ * True if the minute lies between the start of transition i and the
+ * start of the next one, the last transition wraps around the week
+ */
+bool WeeklySchedule::_contains(uint8_t i, uint16_t minute)
+{
+  uint16_t start = _transitions[i].minute;
+  uint16_t end   = _transitions[_nextIndex(i)].minute;
+  if (start < end) return minute >= start && minute < end;
+  return minute >= start || minute < end;
+}
+
+/**
+ * Last transition starting at or before the minute,
+ * the last one of the week before the first one
+ */
+uint8_t WeeklySchedule::_seek(uint16_t minute)
+{
+  if (minute < _transitions[0].minute) return _nbrTransitions - 1;
+  uint8_t lo = 0;
+  uint8_t hi = _nbrTransitions - 1;
+  while (lo < hi)
+  {
+    uint8_t mid = (lo + hi + 1) / 2;
+    if (_transitions[mid].minute <= minute) lo = mid;
+    else hi = mid - 1;
+  }
+  return lo;
+}
+
+bool WeeklySchedule::save(const char *key)
+{
+  Preferences prefs;
+  if (! prefs.begin("schedule")) return false;
+  size_t len = _nbrSlots * sizeof(ScheduleSlot);
+  bool ok = prefs.putBytes(key, _slots, len) == len;
+  prefs.end();
+  return ok;
+}
+
+bool WeeklySchedule::load(const char *key)
+{
+  Preferences prefs;
+  ScheduleSlot slots[SCHEDULE_MAX_SLOTS];
+  if (! prefs.begin("schedule", true)) return false;
+  size_t len = prefs.getBytesLength(key);
+  bool ok = len > 0 && len <= sizeof(slots) && len % sizeof(ScheduleSlot) == 0 && prefs.getBytes(key, slots, len) == len;
+  prefs.end();
+  return ok && setSlots(slots, len / sizeof(ScheduleSlot));
+}
+
+void WeeklySchedule::printSchedule()
+{
+  Serial.printf("Schedule %s, %d slots, %d transitions\n", _isEnabled ? "enabled" : "disabled", _nbrSlots, _nbrTransitions);
+  for (uint8_t i = 0; i < _nbrTransitions; i++)
+  {
+    const ScheduleTransition &t = _transitions[i];
+    Serial.printf("%c %s %02d:%02d  %4.1f..%4.1f °C\n", _isSynced && i == _cursor ? '>' : ' ', dayNames[t.minute / 1440],
+                  t.minute % 1440 / 60, t.minute % 60, t.tLow2 / 2.0f, t.tHigh2 / 2.0f);
+  }
+  if (_isSynced) Serial.printf("next change in %d min\n", getMinutesToNext());
+}
+
+void WeeklySchedule::setClock(uint8_t day, uint8_t hour, uint8_t minute)
+{
+  _msClock    = millis();
+  _sClock     = ((day % 7) * 1440UL + (hour % 24) * 60 + minute % 60) * 60;
+  _isClockSet = true;
+}
+
+bool WeeklySchedule::isClockSet()
+{
+#ifdef ESP32
+  if (time(nullptr) > SCHEDULE_TIME_VALID) return true;
+#endif
+  return _isClockSet;
+}
+
+/**
+ * Local time if the system time has been set, otherwise the clock
+ * of setClock() advanced by the whole seconds elapsed since the last
+ * call, which must be less than 49 days ago
+ */
+uint16_t WeeklySchedule::getMinuteOfWeek()
+{
+#ifdef ESP32
+  time_t now = time(nullptr);
+  if (now > SCHEDULE_TIME_VALID)
+  {
+    struct tm local;
+    localtime_r(&now, &local);
+    return ((local.tm_wday + 6) % 7) * 1440 + local.tm_hour * 60 + local.tm_min;
+  }
+#endif
+  uint32_t s = (millis() - _msClock) / 1000;
+  _msClock += s * 1000;
+  _sClock   = (_sClock + s) % SCHEDULE_SECONDS_PER_WEEK;
+  return _sClock / 60;
+}
+
+void WeeklySchedule::printClock()
+{
+  if (! isClockSet())
+  {
+    Serial.println("Clock not set");
+    return;
+  }
+  uint16_t minute = getMinuteOfWeek();
+  Serial.printf("Clock %s %02d:%02d\n", dayNames[minute / 1440], minute % 1440 / 60, minute % 60);
+}
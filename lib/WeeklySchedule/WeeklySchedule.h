@@ -0,0 +1,100 @@
+/**
+ * Class        WeeklySchedule
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Weekly schedule of the limits of a thermostat. The schedule
+ *              is a compact table of slots, each with the days of the week
+ *              it applies to, the time of day it starts and the limits from
+ *              then on:
+ *
+ *              ScheduleSlot office[] =
+ *              {   //  days           h   m   low  high  (°C x 2)
+ *                { SCHEDULE_WORKDAYS,  6, 30,  40,  44 },
+ *                { SCHEDULE_WORKDAYS, 18,  0,  32,  36 },
+ *                { SCHEDULE_WEEKEND,   0,  0,  32,  36 },
+ *              };
+ *              schedule.setSlots(office, 3);
+ *              schedule.enable();
+ *
+ *              setSlots() compiles the table into a list of transitions
+ *              sorted by the minute of the week. A cursor points to the
+ *              active transition, so loop() only compares the minute of the
+ *              week with the start of the next transition and advances the
+ *              cursor by one when it is reached. Only when the clock has
+ *              jumped, the cursor is searched again. A change of the
+ *              active transition is applied with the limit setters of the
+ *              thermostat.
+ *
+ * Remarks      The limits are in steps of 0.5 °C. The clock is shared by all
+ *              schedules, it is the local time if the system time has been
+ *              set (SNTP), otherwise the time set with setClock(), advanced
+ *              by millis(). A change of the limits over the CLI holds until
+ *              the next transition. save() and load() keep the slots in the
+ *              Preferences (NVS) under namespace "schedule".
+ */
+#pragma once
+#include "Thermostat.h"
+
+#define SCHEDULE_MAX_SLOTS        12   // 5 bytes each in the Preferences
+#define SCHEDULE_MAX_TRANSITIONS  42
+#define SCHEDULE_MINUTES_PER_WEEK (7 * 1440)
+#define SCHEDULE_WORKDAYS         0x1f // Monday .. Friday, bit 0 is Monday
+#define SCHEDULE_WEEKEND          0x60
+#define SCHEDULE_EVERY_DAY        0x7f
+
+using ScheduleSlot = struct scheduleSlot
+{
+  uint8_t days;     // bit 0 Monday .. bit 6 Sunday
+  uint8_t hour;
+  uint8_t minute;
+  uint8_t tLow2;    // °C x 2
+  uint8_t tHigh2;   // °C x 2
+};
+
+using ScheduleTransition = struct scheduleTransition
+{
+  uint16_t minute;  // of the week, 0 is Monday 00:00
+  uint8_t  tLow2;
+  uint8_t  tHigh2;
+};
+
+class WeeklySchedule
+{
+  public:
+    bool     setSlots(const ScheduleSlot *slots, uint8_t nbrSlots);  // false if the table does not fit
+    bool     loop(Thermostat &thermostat);   // true when limits have been applied
+    void     enable();                       // the active limits are applied by the next loop()
+    void     disable();
+    bool     isEnabled();
+    uint8_t  getNbrTransitions();
+    const ScheduleTransition& getActive();
+    const ScheduleTransition& getNext();
+    uint16_t getMinutesToNext();             // from the last loop() to the next transition
+    bool     save(const char *key);          // store the slots in the Preferences
+    bool     load(const char *key);          // set the stored slots, false if there are none
+    void     printSchedule();
+
+    static void     setClock(uint8_t day, uint8_t hour, uint8_t minute);   // day 0 is Monday
+    static bool     isClockSet();
+    static uint16_t getMinuteOfWeek();
+    static void     printClock();
+
+  private:
+    uint8_t _nextIndex(uint8_t i);
+    bool    _contains(uint8_t i, uint16_t minute);
+    uint8_t _seek(uint16_t minute);
+
+    ScheduleSlot       _slots[SCHEDULE_MAX_SLOTS];
+    ScheduleTransition _transitions[SCHEDULE_MAX_TRANSITIONS];
+    uint8_t  _nbrSlots       = 0;
+    uint8_t  _nbrTransitions = 0;
+    uint8_t  _cursor         = 0;     // active transition
+    uint16_t _minuteLast     = 0;     // minute of the week of the last loop()
+    bool     _isSynced       = false; // cursor valid and its limits applied
+    bool     _isEnabled      = false;
+
+    static uint32_t _msClock;         // millis() at _sClock
+    static uint32_t _sClock;          // second of the week
+    static bool     _isClockSet;
+};
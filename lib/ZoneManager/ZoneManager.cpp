@@ -0,0 +1,273 @@
+/**
+ * Class        ZoneManager
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the sampling and evaluation of the heating zones
+ *
+ * Board        ESP32 DoIt DevKit V1
+ *
+ * Remarks      Only ADC1 pins (32..39) can be used for the channels,
+ *              ADC2 is not available while WiFi is running.
+ */
+#include "ZoneManager.h"
+#include "Profiler.h"
+
+void zoneIdle() {}
+
+void ZoneManager::setup()
+{
+  for (uint8_t z = 0; z < _nbrZones; z++)
+  {
+    _zones[z].output.setup();
+    _zones[z].heatingIsOn = false;
+    _zones[z].thermostat.setup();
+    _zones[z].thermostat.enable();
+    if (_zones[z].pwm)
+    {
+      _zones[z].pwm->setup();
+      _zones[z].pwm->setPhase(_zones[z].pwm->getPeriod() * z / _nbrZones);
+    }
+  }
+  if (_adcScan && ! _adcScan->setup()) _adcScan = nullptr;
+  setScanMode(_scanMode);
+  _msNextSample = millis();
+  log_i("==> %d zones", _nbrZones);
+}
+
+/**
+ * One tick: sample when the sample interval has expired, then
+ * evaluate every zone and switch the outputs whose decision changed.
+ * With a coordinator, switching on is requested and done when granted.
+ */
+void ZoneManager::loop()
+{
+  PROFILE_SCOPE(PRB_ZONE_TICK);
+  uint32_t msNow = millis();
+  if ((int32_t)(msNow - _msNextSample) >= 0)
+  {
+    _msNextSample = msNow + _msSample;
+    _sample();
+  }
+
+  for (uint8_t z = 0; z < _nbrZones; z++)
+  {
+    Zone &zone = _zones[z];
+    if (zone.schedule) zone.schedule->loop(zone.thermostat);
+    zone.thermostat.loop();
+    if (zone.pwm && zone.pwm->isEnabled())
+    {
+      _drivePwm(z);
+      continue;
+    }
+    bool on = zone.thermostat.isSwitchOn();
+    if (! _coordinator) 
+    {
+      if (on != zone.heatingIsOn) _switch(z, on);
+    }
+    else if (! on)
+    {
+      _coordinator->release(z);
+      if (zone.heatingIsOn) _switch(z, false);
+    }
+    else if (! zone.heatingIsOn)
+    {
+      _coordinator->request(z, zone.thermostat.getLimitLow() - zone.sensor.getCelsius());
+    }
+  }
+
+  if (_coordinator) _grant(msNow);
+  if (_batch) _batch->commit();
+}
+
+/**
+ * Switch on the zones whose request the coordinator has granted
+ */
+void ZoneManager::_grant(uint32_t msNow)
+{
+  _coordinator->tick(msNow);
+  for (uint8_t z = 0; z < _nbrZones; z++)
+  {
+    if (_coordinator->isGranted(z) && ! _zones[z].heatingIsOn && ! isOutputPwm(z)) _switch(z, true);
+  }
+}
+
+void ZoneManager::_switch(uint8_t z, bool on)
+{
+  _zones[z].output.set(on);
+  _zones[z].heatingIsOn = on;
+  _onSwitch(z, on);
+}
+
+/**
+ * The heater of a zone with time-proportional output is on while 
+ * the duty is above 0. With a coordinator a duty above 0 waits for 
+ * the grant of a slot, which is released when the duty is 0 again 
+ * and the heater is off, since a window may still be in its on-phase.
+ */
+void ZoneManager::_drivePwm(uint8_t z)
+{
+  Zone &zone = _zones[z];
+  zone.pwm->setDuty(zone.thermostat.getControlValue());
+  if (_coordinator)
+  {
+    if (zone.pwm->getDuty() <= 0)
+    {
+      if (! zone.pwm->isOn()) _coordinator->release(z);
+    }
+    else if (! _coordinator->isGranted(z))
+    {
+      _coordinator->request(z, zone.thermostat.getLimitLow() - zone.sensor.getCelsius());
+      zone.pwm->setDuty(0);
+    }
+  }
+  zone.pwm->loop();
+  bool on = zone.pwm->getDuty() > 0;
+  if (on == zone.heatingIsOn) return;
+  zone.heatingIsOn = on;
+  _onSwitch(z, on);
+}
+
+void ZoneManager::_sample()
+{
+  if (_scanMode == SCAN_DMA)
+  {
+    _adcScan->scan();
+    for (uint8_t z = 0; z < _nbrZones; z++) _read(z);
+  }
+  else if (_scanMode == SCAN_ALL)
+  {
+    for (uint8_t z = 0; z < _nbrZones; z++) _read(z);
+  }
+  else
+  {
+    _read(_nextChannel);
+    _nextChannel = _nextChannel + 1 < _nbrZones ? _nextChannel + 1 : 0;
+  }
+}
+
+void ZoneManager::_read(uint8_t z)
+{
+  if (_zones[z].publisher) _zones[z].publisher->publish();
+  else                     _zones[z].sensor.readSensor();
+}
+
+/**
+ * Stagger the switching on of the heaters, call before setup()
+ */
+/**
+ * The coordinator tracks COORD_MAX_ZONES zones, with more of them the
+ * zones beyond would request forever, so the coordinator is not used
+ */
+bool ZoneManager::setCoordinator(SwitchCoordinator &coordinator)
+{
+  if (_nbrZones > COORD_MAX_ZONES)
+  {
+    log_e("%d zones, the coordinator takes at most %d", _nbrZones, COORD_MAX_ZONES);
+    return false;
+  }
+  _coordinator = &coordinator;
+  return true;
+}
+
+/**
+ * The outputs of the zones which stage their changes in the batch,
+ * they are written together at the end of every tick
+ */
+void ZoneManager::setGpioBatch(GpioBatch &batch)
+{
+  _batch = &batch;
+}
+
+/**
+ * The scan must contain the pins of all zones. Call before setup().
+ */
+void ZoneManager::setAdcScan(AdcScan &adcScan)
+{
+  _adcScan = &adcScan;
+}
+
+/**
+ * In SCAN_DMA mode the sensors read their analog value from 
+ * the frame of the ADC scan, it falls back to SCAN_ALL 
+ * if no ADC scan is available
+ */
+void ZoneManager::setScanMode(ScanMode mode)
+{
+  _scanMode = mode == SCAN_DMA && ! _adcScan ? SCAN_ALL : mode;
+  if (_adcScan)
+  {
+    if (_scanMode == SCAN_DMA) _adcScan->start();
+    else                       _adcScan->stop();   // analogRead() needs ADC1
+  }
+  for (uint8_t z = 0; z < _nbrZones; z++)
+  {
+    if (_scanMode == SCAN_DMA) _zones[z].sensor.attachScan(*_adcScan);
+    else                       _zones[z].sensor.detachScan();
+  }
+}
+
+ScanMode ZoneManager::getScanMode()
+{
+  return _scanMode;
+}
+
+/**
+ * Interval between two samplings. In round-robin mode
+ * each channel is sampled every nbrZones intervals.
+ */
+void ZoneManager::setSampleInterval(uint32_t msSample)
+{
+  _msSample = msSample;
+}
+
+/**
+ * Switch between the time-proportional and the on/off output 
+ * of a zone with a SlowPwm, the heater starts switched off
+ */
+void ZoneManager::setOutputPwm(uint8_t z, bool isPwm)
+{
+  Zone &zone = getZone(z);
+  if (! zone.pwm || isPwm == zone.pwm->isEnabled()) return;
+  if (_coordinator) _coordinator->release(z);
+  zone.output.set(false);
+  if (_batch) _batch->commit();
+  if (isPwm) zone.pwm->enable();
+  else       zone.pwm->disable();
+  if (zone.heatingIsOn) _onSwitch(z, false);
+  zone.heatingIsOn = false;
+}
+
+bool ZoneManager::isOutputPwm(uint8_t z)
+{
+  return getZone(z).pwm && getZone(z).pwm->isEnabled();
+}
+
+uint8_t ZoneManager::getNbrZones()
+{
+  return _nbrZones;
+}
+
+Zone& ZoneManager::getZone(uint8_t z)
+{
+  return _zones[z < _nbrZones ? z : 0];
+}
+
+/**
+ * Print one line per zone
+ */
+void ZoneManager::printZones()
+{
+  static const char * const modeNames[] = { "round-robin", "scan all", "DMA scan" };
+  Serial.printf("--- Zones (%s) ---\n", modeNames[_scanMode]);
+  Serial.printf("Zone Name        Pin   Tc °C   Low °C  High °C  Enabled Heating\n");
+  for (uint8_t z = 0; z < _nbrZones; z++)
+  {
+    Zone &zone = _zones[z];
+    Serial.printf("%-4d %-10s %4d %7.1f %8.1f %8.1f  %-7s %s\n", z, zone.name, 
+                  zone.sensor.getDataReference().sensorPin, zone.sensor.getCelsius(),
+                  zone.thermostat.getLimitLow(), zone.thermostat.getLimitHigh(),
+                  zone.thermostat.isEnabled() ? "yes" : "no", 
+                  zone.sensor.getFault() ? "fault" : isOutputPwm(z) ? "pwm" : zone.heatingIsOn ? "on" : _coordinator && _coordinator->isPending(z) ? "waiting" : "off");
+  }
+  Serial.println();
+}
@@ -0,0 +1,112 @@
+/**
+ * Class        ZoneManager
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Manages several heating zones, each with its own NTC channel,
+ *              thermostat with independent limits and heating output. The 
+ *              sensors, thermostats and the table of zones are statically 
+ *              allocated by the application:
+ *
+ *              GpioBatch  batch;
+ *              GpioOutput heaters[] = { { GPIO_NUM_4, &batch }, { GPIO_NUM_16, &batch } };
+ *              Zone zones[] = 
+ *              {
+ *                { "Living", sensor0, thermostat0, heaters[0], false },
+ *                { "Office", sensor1, thermostat1, heaters[1], false },
+ *              };
+ *              ZoneManager zoneManager(zones, 2, onSwitch);
+ *              zoneManager.setGpioBatch(batch);
+ *
+ *              Every sample interval the channels are sampled, either one 
+ *              channel after the other (SCAN_ROUND_ROBIN), all of them with
+ *              analogRead() (SCAN_ALL) or all of them in one DMA pass of the
+ *              ADC scan set with setAdcScan() (SCAN_DMA). Every tick all thermostats are evaluated and the
+ *              outputs of the zones whose decision has changed are switched,
+ *              all in one register write at the end of the tick when the
+ *              outputs share the GpioBatch of the manager (see GpioOutput.h).
+ *              With a coordinator set, the switching on is staggered to cap 
+ *              the load on the supply (see SwitchCoordinator.h), for at most
+ *              COORD_MAX_ZONES zones.
+ *              A zone with a publisher reads its sensor through the publisher, 
+ *              which passes the sample on to its subscribers.
+ *              A zone with a SlowPwm driving its output can be switched to the 
+ *              time-proportional output with setOutputPwm(). Its heater then 
+ *              follows the control value of the thermostat, the windows of 
+ *              the zones are shifted against each other. With a coordinator
+ *              the zone holds a load slot from its first window with a duty
+ *              above 0 until the heater is off with a duty of 0, so the 
+ *              on-phases of the windows count against maxOn.
+ *              A zone with an enabled WeeklySchedule gets the limits of its
+ *              thermostat from the schedule, before the thermostat is
+ *              evaluated.
+ *
+ * Remarks      The manager drives the outputs, the onLowTemp() and onHighTemp()
+ *              callbacks of the thermostats are not needed and the processData()
+ *              callbacks must not read the sensor. onSwitch() is called after 
+ *              an output has been switched, with a batch after its change has
+ *              been staged, the commit follows in the same tick.
+ */
+#pragma once
+#include "Thermostat.h"
+#include "SwitchCoordinator.h"
+#include "SensorPublisher.h"
+#include "SlowPwm.h"
+#include "WeeklySchedule.h"
+#include "GpioOutput.h"
+
+using ScanMode = enum scanMode { SCAN_ROUND_ROBIN, SCAN_ALL, SCAN_DMA };
+using Zone = struct zone 
+{ 
+  const char      *name; 
+  NTCSensor       &sensor; 
+  Thermostat      &thermostat; 
+  IActuator       &output;                // heater output
+  bool             heatingIsOn; 
+  SensorPublisher *publisher;             // publisher of the sensor, if it has further subscribers
+  SlowPwm         *pwm;                   // time-proportional driver of output, if wired to an SSR
+  WeeklySchedule  *schedule;              // weekly schedule of the limits, if any
+};
+using SwitchCallback = void(&)(uint8_t zone, bool on);
+
+class ZoneManager
+{
+  public:
+    ZoneManager(Zone *zones, uint8_t nbrZones, SwitchCallback onSwitch) :
+      _zones(zones), _nbrZones(nbrZones), _onSwitch(onSwitch)
+    {}
+
+    void     setup();   // init outputs, setup and enable the thermostats
+    void     loop();    // sample the channels and evaluate the zones
+    void     setAdcScan(AdcScan &adcScan);   // scan of the zone pins, enables SCAN_DMA
+    bool     setCoordinator(SwitchCoordinator &coordinator);   // false with more than COORD_MAX_ZONES zones
+    void     setGpioBatch(GpioBatch &batch);     // batch of the outputs, committed every tick
+    void     setScanMode(ScanMode mode);
+    ScanMode getScanMode();
+    void     setSampleInterval(uint32_t msSample);
+    void     setOutputPwm(uint8_t z, bool isPwm);   // time-proportional or on/off output
+    bool     isOutputPwm(uint8_t z);
+    uint8_t  getNbrZones();
+    Zone&    getZone(uint8_t z);
+    void     printZones();
+
+  private:
+    void _grant(uint32_t msNow);
+    void _sample();
+    void _read(uint8_t z);
+    void _switch(uint8_t z, bool on);
+    void _drivePwm(uint8_t z);
+
+    Zone          *_zones;
+    uint8_t        _nbrZones;
+    SwitchCallback _onSwitch;
+    AdcScan       *_adcScan      = nullptr;
+    SwitchCoordinator *_coordinator = nullptr;
+    GpioBatch     *_batch        = nullptr;
+    ScanMode       _scanMode     = SCAN_ROUND_ROBIN;
+    uint32_t       _msSample     = 100;
+    uint32_t       _msNextSample = 0;
+    uint8_t        _nextChannel  = 0;   // next channel sampled round-robin
+};
+
+void zoneIdle();   // no-op callback for the thermostats of the zones
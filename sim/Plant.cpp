@@ -0,0 +1,33 @@
+/**
+ * Class        Plant
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Implements the thermal model of the room and the inverse
+ *              conversion of a temperature to the code of the ADC
+ */
+#include "Plant.h"
+
+void Plant::step(float dt, float u)
+{
+  float qHeater   = _p.P * u;
+  float qRadiator = (_tRadiator - _tRoom) / _p.Rr;
+  float qLoss     = (_tRoom - _tAmbient) / _p.Ra;
+  _tRadiator += dt * (qHeater - qRadiator) / _p.Cr;
+  _tRoom     += dt * (qRadiator - qLoss) / _p.Ca;
+  _energy    += dt * qHeater;
+}
+
+/**
+ * Rt = Roo * e^(beta / T), Vin = Vcc * Rt / (Rs + Rt) for the NTC to GND
+ * or Vcc * Rs / (Rs + Rt) for the NTC to Vcc and Aval = (Vin - Voff) / v
+ */
+uint16_t ntcAdcCode(float tCelsius, const ParamsNTC &ntc, const ParamsADC &adc)
+{
+  const double To = 25.0, Tabs = -273.15;
+  double Roo = ntc.Ro * exp(-(double)ntc.beta / (To - Tabs));
+  double Rt  = Roo * exp(ntc.beta / (tCelsius - Tabs));
+  double vin = adc.ntcToGround ? adc.Vcc * Rt / (ntc.Rs + Rt) : adc.Vcc * ntc.Rs / (ntc.Rs + Rt);
+  double v   = (adc.Vref - adc.Voff) / adc.Amax;
+  double code = round((vin - adc.Voff) / v);
+  return code < 0 ? 0 : code > adc.Amax ? adc.Amax : (uint16_t)code;
+}
@@ -0,0 +1,63 @@
+/**
+ * Class        Plant
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Thermal model of a room heated by a radiator for the host
+ *              simulation of the thermostat. The model has two nodes:
+ *
+ *                          Rr                 Ra
+ *              radiator ---/\/\--- room ---/\/\--- ambient
+ *                 Cr                Ca
+ *
+ *              Cr dTr/dt = P * u - (Tr - T) / Rr
+ *              Ca dT/dt  = (Tr - T) / Rr - (T - Tamb) / Ra
+ *
+ *              u is 1 while the heater is on. The heat stored in the radiator
+ *              causes the room temperature to rise after switch off.
+ *
+ * Remarks      Integrated with explicit Euler, the step must be small
+ *              compared to Cr * Rr.
+ */
+#pragma once
+#include "NTCSensor.h"
+
+using PlantParams = struct plantParams
+{
+  float P;     // heating power [W]
+  float Cr;    // heat capacity of radiator [J/K]
+  float Rr;    // thermal resistance radiator to room [K/W]
+  float Ca;    // heat capacity of room [J/K]
+  float Ra;    // thermal resistance room to ambient [K/W]
+};
+
+class Plant
+{
+  public:
+    Plant(const PlantParams &params, float tRoom, float tAmbient) :
+      _p(params), _tRoom(tRoom), _tRadiator(tRoom), _tAmbient(tAmbient)
+    {}
+
+    void  step(float dt, float u);  // dt in s, u = 0..1
+    void  setAmbient(float tAmbient) { _tAmbient = tAmbient; }
+    float getRoom() const     { return _tRoom; }
+    float getRadiator() const { return _tRadiator; }
+    float getAmbient() const  { return _tAmbient; }
+    double getEnergy() const  { return _energy; }  // heat delivered [J]
+
+  private:
+    PlantParams _p;
+    float  _tRoom;
+    float  _tRadiator;
+    float  _tAmbient;
+    double _energy = 0;
+};
+
+// A room of about 50 m3 with an oil radiator of 2 kW
+constexpr PlantParams plantOilRadiator = { 2000.0f, 50e3f, 0.05f, 3e6f, 0.01f };
+
+/**
+ * Inverse of the NTC conversion: the ADC code which the voltage divider
+ * of the NTC at temperature tCelsius produces, clamped to 0..Amax.
+ */
+uint16_t ntcAdcCode(float tCelsius, const ParamsNTC &ntc, const ParamsADC &adc);
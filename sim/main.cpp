@@ -0,0 +1,816 @@
+/**
+ * Program      Host simulation of the thermostat in closed loop
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Runs the unchanged NTCSensor and Thermostat classes against
+ *              the thermal model of a room (see Plant.h). The fake ADC
+ *              delivers the code the NTC would produce at the current room
+ *              temperature and the heater follows the level of PIN_THERMOSTAT.
+ *              Time is virtual, so days are simulated in seconds.
+ *
+ * Usage        pio run -e native_sim && .pio/build/native_sim/program [scenario] [options]
+ *                --days n       simulated time (default 7)
+ *                --step ms      simulation step (default 10)
+ *                --refresh ms   refresh interval of the thermostat (default 10000)
+ *                --zones n      number of zones of the scenario zones (default 6)
+ *                --max-on n     heaters allowed on at the same time (default 4)
+ *                --spacing s    minimum time between two switch ons (default 60)
+ *                --check-fusion fuse stub inputs with outliers, faults and 
+ *                               weights, exit code 1 if a fused value differs
+ *                --check-faults feed an NTCSensor open, shorted, stuck and jumping
+ *                               codes, exit code 1 if a fault is misclassified
+ *
+ * Scenarios    latency   latency from the true crossing of a limit by the
+ *                        room temperature to the switching of the heater
+ *              zones     rooms of different size heated by the zone manager 
+ *                        with staggered switching, reports the peak load, the
+ *                        spacing of the switch ons, the time the rooms spend
+ *                        below the lower limit and the cost of the coordinator
+ *              pwm       on/off against time-proportional output of two equal
+ *                        rooms, reports the spread of the room temperature
+ *                        and the switch ons of the relays, fails if the
+ *                        time-proportional room spreads more
+ *              pid       hysteresis against the PID law, reports in addition
+ *                        the overshoot over the target, fails if a room 
+ *                        spreads more than the one with the hysteresis
+ *              autotune  relay autotuning of the PID gains, then the tuned 
+ *                        against the default gains in closed loop
+ *              predict   hysteresis against the hysteresis switching early
+ *                        by the learned overshoot and undershoot, fails if
+ *                        the peaks beyond the limits are not smaller
+ *              adapt     fixed delta against the band adapted to a switching
+ *                        rate, in a heavy and in a drafty room, fails if the
+ *                        band does not cycle closer to the target
+ *              mpc       model predictive control against hysteresis and PID,
+ *                        reports the identified model and the cycles of the
+ *                        search
+ *              schedule  office hours of a weekly schedule against constant
+ *                        limits, reports the energy, the shortfall below the
+ *                        comfort limit while occupied and the limit changes
+ */
+#include <Arduino.h>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+#include "ZoneManager.h"
+#include "Plant.h"
+#include "Profiler.h"
+#include "PidLaw.h"
+#include "Autotune.h"
+#include "MpcLaw.h"
+#include "WeeklySchedule.h"
+#include "FusedSensor.h"
+
+#define PIN_THERMOSTAT  GPIO_NUM_4
+#define PIN_ADC         GPIO_NUM_34
+
+void processData();
+void turnHeatingOn();
+void turnHeatingOff();
+
+ParamsNTC  ntc = { 10000, 10000, 2800 };
+ParamsADC  adc = { PIN_ADC, true, 4095, ADC_11db, 3300.0, 3200.0, 130.0 };
+SensorData sensorData;
+NTCSensor  sensor(ntc, adc, sensorData);
+Thermostat thermostat(sensor, processData, turnHeatingOn, turnHeatingOff);
+Plant      plant(plantOilRadiator, 16.0f, 5.0f);
+GpioOutput heater(PIN_THERMOSTAT);
+
+// Zones of the scenario zones: sensors on pins 32.., heaters on pins 16..
+ParamsADC  zoneAdc[] = 
+{
+  { 32, true, 4095, ADC_11db, 3300.0, 3200.0, 130.0 }, { 33, true, 4095, ADC_11db, 3300.0, 3200.0, 130.0 },
+  { 34, true, 4095, ADC_11db, 3300.0, 3200.0, 130.0 }, { 35, true, 4095, ADC_11db, 3300.0, 3200.0, 130.0 },
+  { 36, true, 4095, ADC_11db, 3300.0, 3200.0, 130.0 }, { 37, true, 4095, ADC_11db, 3300.0, 3200.0, 130.0 },
+  { 38, true, 4095, ADC_11db, 3300.0, 3200.0, 130.0 }, { 39, true, 4095, ADC_11db, 3300.0, 3200.0, 130.0 },
+};
+SensorData zoneData[8];
+NTCSensor  zoneSensors[] =
+{
+  { ntc, zoneAdc[0], zoneData[0] }, { ntc, zoneAdc[1], zoneData[1] }, { ntc, zoneAdc[2], zoneData[2] }, 
+  { ntc, zoneAdc[3], zoneData[3] }, { ntc, zoneAdc[4], zoneData[4] }, { ntc, zoneAdc[5], zoneData[5] }, 
+  { ntc, zoneAdc[6], zoneData[6] }, { ntc, zoneAdc[7], zoneData[7] },
+};
+Thermostat zoneThermostats[] =
+{
+  { zoneSensors[0], zoneIdle, zoneIdle, zoneIdle }, { zoneSensors[1], zoneIdle, zoneIdle, zoneIdle },
+  { zoneSensors[2], zoneIdle, zoneIdle, zoneIdle }, { zoneSensors[3], zoneIdle, zoneIdle, zoneIdle },
+  { zoneSensors[4], zoneIdle, zoneIdle, zoneIdle }, { zoneSensors[5], zoneIdle, zoneIdle, zoneIdle },
+  { zoneSensors[6], zoneIdle, zoneIdle, zoneIdle }, { zoneSensors[7], zoneIdle, zoneIdle, zoneIdle },
+};
+GpioBatch  zoneBatch;
+GpioOutput zoneOutputs[] =
+{
+  { 16, &zoneBatch }, { 17, &zoneBatch }, { 18, &zoneBatch }, { 19, &zoneBatch },
+  { 21, &zoneBatch }, { 22, &zoneBatch }, { 23, &zoneBatch }, { 25, &zoneBatch },
+};
+Zone zones[] =
+{
+  { "z0", zoneSensors[0], zoneThermostats[0], zoneOutputs[0], false }, { "z1", zoneSensors[1], zoneThermostats[1], zoneOutputs[1], false },
+  { "z2", zoneSensors[2], zoneThermostats[2], zoneOutputs[2], false }, { "z3", zoneSensors[3], zoneThermostats[3], zoneOutputs[3], false },
+  { "z4", zoneSensors[4], zoneThermostats[4], zoneOutputs[4], false }, { "z5", zoneSensors[5], zoneThermostats[5], zoneOutputs[5], false },
+  { "z6", zoneSensors[6], zoneThermostats[6], zoneOutputs[6], false }, { "z7", zoneSensors[7], zoneThermostats[7], zoneOutputs[7], false },
+};
+//                    P     Cr     Rr     Ca     Ra     room  ambient
+Plant zonePlants[] =
+{
+  { { 2000.0f, 50e3f, 0.05f, 3.0e6f, 0.010f }, 15.0f, 5.0f },
+  { { 1500.0f, 40e3f, 0.06f, 2.0e6f, 0.014f }, 16.0f, 5.0f },
+  { { 2500.0f, 60e3f, 0.04f, 4.0e6f, 0.008f }, 14.5f, 5.0f },
+  { { 1000.0f, 30e3f, 0.08f, 1.5e6f, 0.020f }, 17.0f, 5.0f },
+  { { 2000.0f, 50e3f, 0.05f, 3.5e6f, 0.011f }, 15.5f, 5.0f },
+  { { 1500.0f, 40e3f, 0.06f, 2.5e6f, 0.013f }, 16.5f, 5.0f },
+  { { 2000.0f, 50e3f, 0.05f, 2.5e6f, 0.012f }, 15.0f, 5.0f },
+  { { 1200.0f, 35e3f, 0.07f, 1.8e6f, 0.017f }, 16.0f, 5.0f },
+};
+SwitchCoordinator coordinator(2, 60000);
+
+using SimConfig = struct simConfig { float days; uint32_t msStep; uint32_t msRefresh; uint8_t nbrZones; uint8_t maxOn; float sSpacing; };
+SimConfig cfg = { 7.0f, 10, 10000, 6, 4, 60.0f };
+
+bool     crossPending = false;  // a limit was crossed, switching is pending
+double   sCross       = 0;      // simulated time of the crossing [s]
+std::vector<double> latencies;  // crossing to switching [ms]
+
+uint64_t usSim        = 0;      // simulated time, micros() wraps after 71 minutes
+
+uint16_t simAdc(uint8_t pin) { return ntcAdcCode(plant.getRoom(), ntc, adc); }
+uint16_t zoneSimAdc(uint8_t pin) { return ntcAdcCode(zonePlants[(pin - 32) & 7].getRoom(), ntc, adc); }
+
+void processData() { sensor.readSensor(); }
+
+void recordLatency()
+{
+  if (crossPending) latencies.push_back(usSim / 1000.0 - sCross * 1000.0);
+  crossPending = false;
+}
+
+void turnHeatingOn()
+{
+  if (! heater.isOn())
+  {
+    heater.set(true);
+    recordLatency();
+  }
+}
+
+void turnHeatingOff()
+{
+  if (heater.isOn())
+  {
+    heater.set(false);
+    recordLatency();
+  }
+}
+
+/**
+ * Advance the simulation by one step: run the thermostat, then let the
+ * room evolve with the heater state. The ambient temperature follows a
+ * daily cycle between 0 and 10 °C. A crossing of a limit in the direction
+ * which requires switching is interpolated within the step.
+ */
+void simStep()
+{
+  usSim += 1000ULL * cfg.msStep;
+  hostSetMicros(usSim);
+  thermostat.loop();
+
+  float  tBefore = plant.getRoom();
+  double s = usSim / 1e6;
+  plant.setAmbient(5.0f + 5.0f * sinf(2.0f * M_PI * s / 86400.0));
+  plant.step(cfg.msStep / 1000.0f, digitalRead(PIN_THERMOSTAT) == HIGH ? 1.0f : 0.0f);
+  float  tAfter = plant.getRoom();
+
+  float limit = heater.isOn() ? thermostat.getLimitHigh() : thermostat.getLimitLow();
+  bool crossed = heater.isOn() ? (tBefore <= limit && tAfter > limit) : (tBefore >= limit && tAfter < limit);
+  if (crossed && ! crossPending)
+  {
+    crossPending = true;
+    sCross = s - cfg.msStep / 1000.0 * (tAfter - limit) / (tAfter - tBefore);
+  }
+}
+
+void printDistribution(const char *title, std::vector<double> &v)
+{
+  if (v.empty()) { printf("%s: no events\n", title); return; }
+  std::sort(v.begin(), v.end());
+  auto at = [&v](double q) { return v[(size_t)(q * (v.size() - 1))]; };
+  double sum = 0;
+  for (double x : v) sum += x;
+  printf("%s [ms]\n  events %zu  min %.0f  mean %.0f  p50 %.0f  p90 %.0f  p99 %.0f  max %.0f\n",
+         title, v.size(), v.front(), sum / v.size(), at(0.5), at(0.9), at(0.99), v.back());
+}
+
+/**
+ * Latency from the true crossing of a limit to the switching of the heater.
+ * It is the quantization of the refresh interval (mean msRefresh / 2) plus 
+ * the time the room needs to change by one step of the ADC (~0.025 °C).
+ * With the slow rooms this second part dominates.
+ */
+int scenarioLatency()
+{
+  uint64_t usEnd = usSim + (uint64_t)(cfg.days * 86400e6);
+  while (usSim < usEnd) simStep();
+
+  printf("refresh %u ms, step %u ms, %.1f days\n", (unsigned)cfg.msRefresh, (unsigned)cfg.msStep, cfg.days);
+  printDistribution("crossing to switching", latencies);
+  return 0;
+}
+
+uint8_t  nbrOn       = 0;      // heaters on
+uint8_t  maxOn       = 0;      // peak number of heaters on
+uint32_t nbrSwitchOn = 0;
+double   sLastOn     = -1;     // time of the last switch on [s]
+double   minSpacing  = 1e9;    // between two switch ons [s]
+
+void onZoneSwitch(uint8_t zone, bool on)
+{
+  double s = usSim / 1e6;
+  if (! on) { nbrOn--; return; }
+  nbrOn++;
+  nbrSwitchOn++;
+  maxOn = std::max(maxOn, nbrOn);
+  if (sLastOn >= 0) minSpacing = std::min(minSpacing, s - sLastOn);
+  sLastOn = s;
+}
+
+/**
+ * Rooms of different size and insulation which all start below the 
+ * lower limit, so every zone demands heat at once. The coordinator 
+ * must keep the number of heaters on at or below maxOn and the switch 
+ * ons at least spacing apart. The price is the time the rooms spend 
+ * below the lower limit while they wait.
+ */
+int scenarioZones()
+{
+  uint8_t n = std::min<uint8_t>(cfg.nbrZones, 8);
+  ZoneManager manager(zones, n, onZoneSwitch);
+  manager.setGpioBatch(zoneBatch);
+  double sBelow[8] = {};
+
+  hostSetAnalogReader(zoneSimAdc);
+  coordinator.setMaxOn(cfg.maxOn);
+  coordinator.setSpacing((uint32_t)(cfg.sSpacing * 1000));
+  manager.setCoordinator(coordinator);
+  manager.setup();
+  for (uint8_t z = 0; z < n; z++) zoneThermostats[z].setRefreshInterval(cfg.msRefresh);
+  usSim = hostGetMicros();
+  Profiler::reset();
+
+  uint64_t usEnd = usSim + (uint64_t)(cfg.days * 86400e6);
+  while (usSim < usEnd)
+  {
+    usSim += 1000ULL * cfg.msStep;
+    hostSetMicros(usSim);
+    manager.loop();
+    float tAmbient = 5.0f + 5.0f * sinf(2.0f * M_PI * (usSim / 1e6) / 86400.0);
+    for (uint8_t z = 0; z < n; z++)
+    {
+      zonePlants[z].setAmbient(tAmbient);
+      zonePlants[z].step(cfg.msStep / 1000.0f, digitalRead(zoneOutputs[z].getPin()) == HIGH ? 1.0f : 0.0f);
+      if (zonePlants[z].getRoom() < zoneThermostats[z].getLimitLow()) sBelow[z] += cfg.msStep / 1000.0;
+    }
+  }
+
+  printf("%d zones, max on %d, spacing %.0f s, refresh %u ms, step %u ms, %.1f days\n", n, cfg.maxOn, 
+         cfg.sSpacing, (unsigned)cfg.msRefresh, (unsigned)cfg.msStep, cfg.days);
+  printf("switch ons %u  peak heaters on %d  min spacing %.1f s\n", (unsigned)nbrSwitchOn, maxOn, minSpacing);
+  printf("zone  below lower limit [s]  energy [kWh]\n");
+  for (uint8_t z = 0; z < n; z++) 
+  {
+    printf("%-4d %20.0f %13.1f\n", z, sBelow[z], zonePlants[z].getEnergy() / 3.6e6);
+  }
+  ProbeStats st = Profiler::getStats(PRB_COORDINATOR);
+  printf("coordinator tick [cycles]  count %u  min %u  mean %u  max %u (includes preemption of the host)\n", (unsigned)st.count, (unsigned)st.min,
+         (unsigned)(st.count ? st.sum / st.count : 0), (unsigned)st.max);
+  return maxOn <= cfg.maxOn && (nbrSwitchOn < 2 || minSpacing >= cfg.sSpacing - 0.001) ? 0 : 1;
+}
+
+// Room temperature statistics of a zone after the warm-up
+using RoomStats = struct roomStats { double n, sum, sum2; float tMin, tMax, overshoot; uint32_t nbrSwitchOn; bool wasOn; };
+
+void addRoomStats(RoomStats &st, float t, bool on)
+{
+  if (on && ! st.wasOn) st.nbrSwitchOn++;
+  st.wasOn = on;
+  st.n++;
+  st.sum  += t;
+  st.sum2 += (double)t * t;
+  st.tMin  = std::min(st.tMin, t);
+  st.tMax  = std::max(st.tMax, t);
+}
+
+double roomSd(const RoomStats &st)
+{
+  double mean = st.sum / st.n;
+  return sqrt(st.sum2 / st.n - mean * mean);
+}
+
+// Peak excursion of the room temperature below and above the limits
+float roomExcursion(const RoomStats &st, float tLow, float tHigh)
+{
+  return std::max(tLow - st.tMin, 0.0f) + std::max(st.tMax - tHigh, 0.0f);
+}
+
+// Output and control law of a room compared by compareRooms()
+using RoomSetup = struct roomSetup { const char *name; bool isPwm; IControlLaw *law; SwitchPredictor *predictor; AdaptiveBand *band; };
+
+/**
+ * Equal rooms, all starting at 15 °C, heated with the outputs and control 
+ * laws of the setups. The overshoot is the peak of the room temperature 
+ * over the target, which is the upper limit for the hysteresis and the 
+ * setpoint for a control law. It, the spread of the temperatures and the
+ * switch ons of the relays are taken after a warm-up of 6 hours or hWarm,
+ * so the heat-up from 15 °C does not count. The statistics of the rooms
+ * are copied to results, if given.
+ */
+int compareRooms(RoomSetup *setups, uint8_t n, float hWarm = 6, RoomStats *results = nullptr)
+{
+  SlowPwm pwms[] = { { zoneOutputs[0], 10000 }, { zoneOutputs[1], 10000 }, { zoneOutputs[2], 10000 }, { zoneOutputs[3], 10000 } };
+  RoomStats st[4];
+  n = std::min<uint8_t>(n, 4);
+  for (uint8_t z = 0; z < n; z++)
+  {
+    zones[z].pwm  = &pwms[z];
+    zonePlants[z] = zonePlants[0];
+    zoneThermostats[z].setControlLaw(setups[z].law);
+    zoneThermostats[z].setPredictor(setups[z].predictor);
+    zoneThermostats[z].setAdaptiveBand(setups[z].band);
+    st[z] = { 0, 0, 0, 99, -99, -99, 0, false };
+  }
+  ZoneManager manager(zones, n, onZoneSwitch);
+  manager.setGpioBatch(zoneBatch);
+
+  hostSetAnalogReader(zoneSimAdc);
+  manager.setup();
+  for (uint8_t z = 0; z < n; z++) 
+  {
+    manager.setOutputPwm(z, setups[z].isPwm);
+    zoneThermostats[z].setRefreshInterval(cfg.msRefresh);
+  }
+  usSim = hostGetMicros();
+
+  uint64_t usWarm = usSim + (uint64_t)(hWarm * 3600e6);
+  uint64_t usEnd  = usWarm + (uint64_t)(cfg.days * 86400e6);
+  while (usSim < usEnd)
+  {
+    usSim += 1000ULL * cfg.msStep;
+    hostSetMicros(usSim);
+    manager.loop();
+    float tAmbient = 5.0f + 5.0f * sinf(2.0f * M_PI * (usSim / 1e6) / 86400.0);
+    for (uint8_t z = 0; z < n; z++)
+    {
+      Thermostat &th = zoneThermostats[z];
+      bool  on = digitalRead(zoneOutputs[z].getPin()) == HIGH;
+      float target = setups[z].law ? (th.getLimitLow() + th.getLimitHigh()) / 2 : th.getLimitHigh();
+      zonePlants[z].setAmbient(tAmbient);
+      zonePlants[z].step(cfg.msStep / 1000.0f, on ? 1.0f : 0.0f);
+      if (usSim < usWarm) continue;
+      st[z].overshoot = std::max(st[z].overshoot, zonePlants[z].getRoom() - target);
+      addRoomStats(st[z], zonePlants[z].getRoom(), on);
+    }
+  }
+
+  printf("limits %.1f..%.1f °C, refresh %u ms, step %u ms, %.1f days\n", zoneThermostats[0].getLimitLow(), 
+         zoneThermostats[0].getLimitHigh(), (unsigned)cfg.msRefresh, (unsigned)cfg.msStep, cfg.days);
+  printf("output                  mean °C  sd °C  min °C  max °C  overshoot °C  switch ons  energy [kWh]\n");
+  for (uint8_t z = 0; z < n; z++)
+  {
+    printf("%-22s %8.2f %6.2f %7.2f %7.2f %13.2f %11u %13.1f\n", setups[z].name, st[z].sum / st[z].n, roomSd(st[z]),
+           st[z].tMin, st[z].tMax, st[z].overshoot, (unsigned)st[z].nbrSwitchOn, zonePlants[z].getEnergy() / 3.6e6);
+    zoneThermostats[z].setControlLaw(nullptr);
+    zoneThermostats[z].setPredictor(nullptr);
+    zoneThermostats[z].setAdaptiveBand(nullptr);
+    zones[z].pwm = nullptr;
+  }
+  if (results) std::copy(st, st + n, results);
+  return 0;
+}
+
+/**
+ * Pass criterion of the comparisons: the room temperature of a setup 
+ * spreads less than that of the baseline, the first setup
+ */
+int checkSpread(const RoomSetup *setups, const RoomStats *st, uint8_t n)
+{
+  int rc = 0;
+  for (uint8_t z = 1; z < n; z++)
+  {
+    if (roomSd(st[z]) < roomSd(st[0])) continue;
+    printf("FAIL %s spreads more than %s\n", setups[z].name, setups[0].name);
+    rc = 1;
+  }
+  return rc;
+}
+
+/**
+ * On/off with the hysteresis of the limits against the 
+ * time-proportional output (10 s windows)
+ */
+int scenarioPwm()
+{
+  RoomSetup setups[] = { { "on/off", false, nullptr }, { "time-proportional", true, nullptr } };
+  RoomStats st[2];
+  compareRooms(setups, 2, 6, st);
+  return checkSpread(setups, st, 2);
+}
+
+/**
+ * The PID law against the hysteresis, with the time-proportional 
+ * and with the on/off output
+ */
+int scenarioPid()
+{
+  PidLaw pid[2];
+  RoomSetup setups[] = 
+  { 
+    { "hysteresis on/off",     false, nullptr }, 
+    { "proportional time-p.",  true,  nullptr }, 
+    { "PID time-proportional", true,  &pid[0] }, 
+    { "PID on/off",            false, &pid[1] },
+  };
+  RoomStats st[4];
+  compareRooms(setups, 4, 6, st);
+  return checkSpread(setups, st, 4);
+}
+
+/**
+ * Relay autotuning of the PID gains of a room, then the tuned gains 
+ * against the default gains and the hysteresis in closed loop
+ */
+int scenarioAutotune()
+{
+  Plant    initial = zonePlants[0];
+  Autotune autotune;
+  ZoneManager manager(zones, 1, onZoneSwitch);
+  manager.setGpioBatch(zoneBatch);
+
+  hostSetAnalogReader(zoneSimAdc);
+  manager.setup();
+  zoneThermostats[0].setRefreshInterval(cfg.msRefresh);
+  autotune.start(zoneSensors[0].getNoiseCelsius());
+  zoneThermostats[0].setControlLaw(&autotune);
+  usSim = hostGetMicros();
+  uint64_t usStart = usSim;
+  uint64_t usEnd   = usSim + 3 * 86400e6;
+  while (autotune.getState() == TUNE_RUNNING && usSim < usEnd)
+  {
+    usSim += 1000ULL * cfg.msStep;
+    hostSetMicros(usSim);
+    manager.loop();
+    zonePlants[0].setAmbient(5.0f + 5.0f * sinf(2.0f * M_PI * (usSim / 1e6) / 86400.0));
+    zonePlants[0].step(cfg.msStep / 1000.0f, digitalRead(zoneOutputs[0].getPin()) == HIGH ? 1.0f : 0.0f);
+  }
+  zoneThermostats[0].setControlLaw(nullptr);
+
+  PidParams p = autotune.getParams();
+  printf("autotune %s after %.1f h\n", Autotune::stateName(autotune.getState()), (usSim - usStart) / 3600e6);
+  if (autotune.getState() != TUNE_DONE) return 1;
+  printf("Pu %.0f s  a %.2f °C  Ku %.3f /°C\n", autotune.getPeriod(), autotune.getAmplitude(), autotune.getUltimateGain());
+  printf("Kp %.3f /°C  Ki %.6f /°Cs  Kd %.1f s/°C  Tf %.0f s\n\n", p.kp, p.ki, p.kd, p.tf);
+
+  zonePlants[0] = initial;
+  PidLaw fixed;
+  PidLaw tuned(p);
+  RoomSetup setups[] = 
+  { 
+    { "hysteresis on/off", false, nullptr }, 
+    { "PID default gains", true,  &fixed }, 
+    { "PID autotuned",     true,  &tuned },
+  };
+  return compareRooms(setups, 3);
+}
+
+/**
+ * The hysteresis switching at the limits against the hysteresis 
+ * switching early by the learned overshoot and undershoot
+ */
+int scenarioPredict()
+{
+  SwitchPredictor predictor;
+  RoomSetup setups[] = 
+  { 
+    { "hysteresis on/off", false, nullptr, nullptr }, 
+    { "predictive on/off", false, nullptr, &predictor },
+  };
+  RoomStats st[2];
+  compareRooms(setups, 2, 48, st);
+  printf("\n");
+  printf("heat-up %.2f °C/h  coast %.2f °C/h  lag off %.0f s  on %.0f s  overshoot %.2f °C  undershoot %.2f °C\n", predictor.getRateHeat() * 3600, predictor.getRateCool() * 3600, predictor.getTauOff(), predictor.getTauOn(), predictor.getOvershoot(), predictor.getUndershoot());
+  float tLow  = zoneThermostats[0].getLimitLow();
+  float tHigh = zoneThermostats[0].getLimitHigh();
+  float baseline  = roomExcursion(st[0], tLow, tHigh);
+  float predicted = roomExcursion(st[1], tLow, tHigh);
+  printf("excursion beyond the limits %.2f °C, switching early %.2f °C\n", baseline, predicted);
+  if (predicted < baseline && st[1].nbrSwitchOn <= st[0].nbrSwitchOn + st[0].nbrSwitchOn / 4) return 0;
+  printf("FAIL %s is not better than %s\n", setups[1].name, setups[0].name);
+  return 1;
+}
+
+/**
+ * The fixed delta of 3 °C against the band adapted to 2 cycles per hour,
+ * first in the heavy room with the oil radiator, then in a light and 
+ * drafty room with a fan heater. Fails unless the adaptive band cycles
+ * closer to the target than the fixed one in both rooms.
+ */
+int scenarioAdapt()
+{
+  //                                  P      Cr     Rr     Ca     Ra
+  constexpr PlantParams draftyRoom = { 3000.0f, 3e3f, 0.02f, 2e5f, 0.009f };
+  Plant initial = zonePlants[0];
+  AdaptiveBand band[2];
+  RoomSetup setups[][2] = 
+  { 
+    { { "heavy fixed delta",    false, nullptr, nullptr, nullptr }, { "heavy adaptive band",  false, nullptr, nullptr, &band[0] } },
+    { { "drafty fixed delta",   false, nullptr, nullptr, nullptr }, { "drafty adaptive band", false, nullptr, nullptr, &band[1] } },
+  };
+  RoomStats st[2];
+  int rc = 0;
+  for (uint8_t r = 0; r < 2; r++)
+  {
+    if (r == 1) zonePlants[0] = Plant(draftyRoom, 19.5f, 5.0f);
+    compareRooms(setups[r], 2, 48, st);
+    float target = band[r].getParams().cyclesPerHour;
+    float fixed  = st[0].nbrSwitchOn / (cfg.days * 24);
+    float adapt  = st[1].nbrSwitchOn / (cfg.days * 24);
+    printf("band %.2f °C, bias %+.2f °C, %.2f cycles/h against %.2f cycles/h of the fixed delta\n\n", 
+           band[r].getDelta(), band[r].getBias(), adapt, fixed);
+    if (fabsf(adapt - target) < fabsf(fixed - target)) continue;
+    printf("FAIL %s is not closer to %.1f cycles/h than %s\n\n", setups[r][1].name, target, setups[r][0].name);
+    rc = 1;
+  }
+  zonePlants[0] = initial;
+  return rc;
+}
+
+/**
+ * The model predictive law against the hysteresis and the PID law, all 
+ * with the on/off output. Reports the identified model and the cycles
+ * of the search of the MPC.
+ */
+int scenarioMpc()
+{
+  PidLaw pid;
+  MpcLaw mpc;
+  RoomSetup setups[] = 
+  { 
+    { "hysteresis on/off", false, nullptr, nullptr, nullptr }, 
+    { "PID on/off",        false, &pid,    nullptr, nullptr },
+    { "MPC on/off",        false, &mpc,    nullptr, nullptr },
+  };
+  Profiler::reset();
+  int rc = compareRooms(setups, 3, 24);
+  float a, b, c;
+  mpc.getModel(a, b, c);
+  ProbeStats st = Profiler::getStats(PRB_MPC_SOLVE);
+  printf("\nmodel T' = %.4f T + %.3f u(k-%u) + %.3f (T - %.0f °C), steps of %.0f s, rms error %.3f °C\n", a, b, 
+         (unsigned)mpc.getDeadTime(), c, MPC_T_REF, mpcParamsRoom.sStep, mpc.getModelError());
+  printf("search [cycles]  count %u  min %u  mean %u  max %u (includes preemption of the host)\n", (unsigned)st.count, 
+         (unsigned)st.min, (unsigned)(st.count ? st.sum / st.count : 0), (unsigned)st.max);
+  return rc | (mpc.isIdentified() ? 0 : 1);
+}
+
+/**
+ * Two equal rooms, one at 20..22 °C all week, the other following the 
+ * office hours of a weekly schedule, 16..18 °C outside of them. The 
+ * clock starts on Monday 00:00 with the virtual time. Every change of 
+ * the limits must fall on the minute of a transition of the schedule.
+ */
+int scenarioSchedule()
+{
+  ScheduleSlot always[] = { { SCHEDULE_EVERY_DAY, 0, 0, 40, 44 } };
+  ScheduleSlot office[] = 
+  { 
+    { SCHEDULE_WORKDAYS,  6, 30, 40, 44 }, 
+    { SCHEDULE_WORKDAYS, 18,  0, 32, 36 }, 
+    { SCHEDULE_WEEKEND,   0,  0, 32, 36 },
+  };
+  const char *names[] = { "constant 20..22 °C", "office hours" };
+  WeeklySchedule schedule[2];
+  schedule[0].setSlots(always, 1);
+  schedule[1].setSlots(office, 3);
+  double   kh[2]   = { 0, 0 };   // K h below 20 °C while the office is occupied
+  uint32_t nbrChanges = 0;
+  uint32_t nbrLate    = 0;
+  for (uint8_t z = 0; z < 2; z++)
+  {
+    zonePlants[z]  = zonePlants[0];
+    zones[z].schedule = &schedule[z];
+    schedule[z].enable();
+  }
+  ZoneManager manager(zones, 2, onZoneSwitch);
+  manager.setGpioBatch(zoneBatch);
+
+  hostSetAnalogReader(zoneSimAdc);
+  manager.setup();
+  for (uint8_t z = 0; z < 2; z++) zoneThermostats[z].setRefreshInterval(cfg.msRefresh);
+  usSim = hostGetMicros();
+  WeeklySchedule::setClock(0, 0, 0);
+
+  float    tHighLast = 0;
+  uint64_t usEnd = usSim + (uint64_t)(cfg.days * 86400e6);
+  while (usSim < usEnd)
+  {
+    usSim += 1000ULL * cfg.msStep;
+    hostSetMicros(usSim);
+    manager.loop();
+    if (zoneThermostats[1].getLimitHigh() != tHighLast)
+    {
+      tHighLast = zoneThermostats[1].getLimitHigh();
+      nbrChanges++;
+      if (WeeklySchedule::getMinuteOfWeek() != schedule[1].getActive().minute && nbrChanges > 1) nbrLate++;
+    }
+    bool  isOccupied = schedule[1].getActive().tLow2 == 40;
+    float tAmbient = 5.0f + 5.0f * sinf(2.0f * M_PI * (usSim / 1e6) / 86400.0);
+    for (uint8_t z = 0; z < 2; z++)
+    {
+      zonePlants[z].setAmbient(tAmbient);
+      zonePlants[z].step(cfg.msStep / 1000.0f, digitalRead(zoneOutputs[z].getPin()) == HIGH ? 1.0f : 0.0f);
+      if (isOccupied) kh[z] += std::max(0.0f, 20.0f - zonePlants[z].getRoom()) * cfg.msStep / 3.6e6;
+    }
+  }
+
+  printf("refresh %u ms, step %u ms, %.1f days\n", (unsigned)cfg.msRefresh, (unsigned)cfg.msStep, cfg.days);
+  printf("limits                energy [kWh]  below 20 °C occupied [K h]\n");
+  for (uint8_t z = 0; z < 2; z++)
+  {
+    printf("%-22s %12.1f %28.2f\n", names[z], zonePlants[z].getEnergy() / 3.6e6, kh[z]);
+    zones[z].schedule = nullptr;
+  }
+  printf("%u limit changes, %u not at a transition, %d transitions per week\n", (unsigned)nbrChanges, (unsigned)nbrLate, 
+         schedule[1].getNbrTransitions());
+  return nbrLate == 0 ? 0 : 1;
+}
+
+// Input of the fusion check with a given temperature and fault
+class StubSensor : public ISensor
+{
+  public:
+    void  set(float t, SensorFault fault) { _data.tCelsius = t; _fault = fault; }
+    void  setup() override {}
+    void  readSensor() override {}
+    float getCelsius() override { return _data.tCelsius; }
+    void  printData() override {}
+    SensorData& getDataReference() override { return _data; }
+    SensorFault getFault() override { return _fault; }
+  private:
+    SensorData  _data;
+    SensorFault _fault = FAULT_NONE;
+};
+
+using FusionCase = struct fusionCase 
+{ 
+  const char *name; 
+  float t[3]; SensorFault fault[3]; float weight[3];   // of the inputs
+  float tFused; uint8_t nbrAccepted; SensorFault fused; 
+};
+
+/**
+ * Fuse 3 stub inputs for every case and compare the temperature, the 
+ * accepted inputs and the fault with the expected ones. With no valid 
+ * input the temperature of the case before is kept.
+ */
+int checkFusion()
+{
+  const FusionCase cases[] =
+  {
+    { "all agree",        { 20.0f, 20.2f, 20.4f }, { FAULT_NONE, FAULT_NONE, FAULT_NONE },      { 1, 1, 1 }, 20.2f,  3, FAULT_NONE },
+    { "weighted mean",    { 20.0f, 21.0f, 20.4f }, { FAULT_NONE, FAULT_NONE, FAULT_NONE },      { 1, 3, 1 }, 20.68f, 3, FAULT_NONE },
+    { "outlier rejected", { 20.0f, 35.0f, 20.2f }, { FAULT_NONE, FAULT_NONE, FAULT_NONE },      { 1, 1, 1 }, 20.1f,  2, FAULT_NONE },
+    { "faulty input",     { 20.0f, 19.0f, 20.2f }, { FAULT_NONE, FAULT_JUMP, FAULT_NONE },      { 1, 1, 1 }, 20.1f,  2, FAULT_NONE },
+    { "not plausible",    { NAN,   20.0f, 150.0f}, { FAULT_NONE, FAULT_NONE, FAULT_NONE },      { 1, 1, 1 }, 20.0f,  1, FAULT_NONE },
+    { "no agreement",     { 20.0f, 25.0f, 30.0f }, { FAULT_NONE, FAULT_NONE, FAULT_RAIL_LOW },  { 1, 2, 1 }, 25.0f,  1, FAULT_NONE },
+    { "no valid input",   { 20.0f, 20.0f, 20.0f }, { FAULT_STUCK, FAULT_RAIL_HIGH, FAULT_JUMP },{ 1, 1, 1 }, 25.0f,  0, FAULT_NO_INPUT },
+  };
+  StubSensor stubs[3];
+  SensorData data;
+  int failed = 0;
+  for (const FusionCase &c : cases)
+  {
+    FusedInput inputs[] = { { stubs[0], c.weight[0] }, { stubs[1], c.weight[1] }, { stubs[2], c.weight[2] } };
+    FusedSensor fused(inputs, 3, data);
+    for (uint8_t i = 0; i < 3; i++) stubs[i].set(c.t[i], c.fault[i]);
+    fused.readSensor();
+    bool ok = fabsf(fused.getCelsius() - c.tFused) < 0.005f && fused.getNbrAccepted() == c.nbrAccepted && fused.getFault() == c.fused;
+    printf("%-18s %6.2f °C  %u accepted  quality %.2f  %s\n", c.name, fused.getCelsius(), (unsigned)fused.getNbrAccepted(), 
+           fused.getQuality(), ok ? "ok" : "FAIL");
+    if (! ok) failed++;
+  }
+  printf("%s\n", failed ? "FAIL fusion" : "fusion as expected");
+  return failed ? 1 : 0;
+}
+
+uint16_t faultCode;   // delivered by faultAdc()
+uint16_t faultAdc(uint8_t pin) { return faultCode; }
+
+using FaultCase = struct faultCase { const char *name; uint16_t code; uint16_t nbrSamples; SensorFault fault; };
+
+/**
+ * Feed an NTCSensor with the default fault parameters a sequence of 
+ * codes, one per second, and compare the fault after every step of the
+ * sequence with the expected one. A not finite temperature cannot come
+ * from the conversion, it is checked with the detector alone.
+ */
+int checkFaults()
+{
+  uint16_t t20 = ntcAdcCode(20.0f, ntc, adc);
+  uint16_t t205 = ntcAdcCode(20.5f, ntc, adc);
+  uint16_t t25 = ntcAdcCode(25.0f, ntc, adc);
+  const FaultCase cases[] =
+  {
+    { "20 °C",             t20,  1, FAULT_NONE },
+    { "20.5 °C",           t205, 1, FAULT_NONE },
+    { "NTC open",         4095,  1, FAULT_RAIL_HIGH },
+    { "recovered",         t20,  1, FAULT_NONE },
+    { "NTC shorted",         0,  1, FAULT_RAIL_LOW },
+    { "recovered",         t205, 1, FAULT_NONE },
+    { "jump to 25 °C",     t25,  1, FAULT_JUMP },
+    { "recovered",         t20,  1, FAULT_NONE },
+    { "constant 599 more", t20, 599, FAULT_NONE },
+    { "stuck",             t20,  1, FAULT_STUCK },
+    { "recovered",         t205, 1, FAULT_NONE },
+  };
+  SensorData data;
+  NTCSensor  probe(ntc, adc, data);
+  hostSetAnalogReader(faultAdc);
+  int failed = 0;
+  for (const FaultCase &c : cases)
+  {
+    faultCode = c.code;
+    for (uint16_t i = 0; i < c.nbrSamples; i++)
+    {
+      hostAdvanceMicros(1000000);
+      probe.readSensor();
+    }
+    bool ok = probe.getFault() == c.fault;
+    printf("%-18s %4u  %-10s %s\n", c.name, (unsigned)c.code, FaultDetector::faultName(probe.getFault()), ok ? "ok" : "FAIL");
+    if (! ok) failed++;
+  }
+  FaultDetector detector;
+  SensorFault fault = detector.check(t20, adc.Amax, NAN, 0);
+  printf("%-18s %4u  %-10s %s\n", "not finite", (unsigned)t20, FaultDetector::faultName(fault), fault == FAULT_NOT_FINITE ? "ok" : "FAIL");
+  if (fault != FAULT_NOT_FINITE) failed++;
+  printf("%s\n", failed ? "FAIL fault classification" : "faults classified as expected");
+  return failed ? 1 : 0;
+}
+
+using Scenario = struct scenario { const char *name; int (&run)(); };
+
+Scenario scenarios[] =
+{
+  { "latency", scenarioLatency },
+  { "zones",   scenarioZones },
+  { "pwm",     scenarioPwm },
+  { "pid",     scenarioPid },
+  { "autotune", scenarioAutotune },
+  { "predict",  scenarioPredict },
+  { "adapt",    scenarioAdapt },
+  { "mpc",      scenarioMpc },
+  { "schedule", scenarioSchedule },
+};
+constexpr uint8_t nbrScenarios = sizeof(scenarios) / sizeof(scenarios[0]);
+
+int main(int argc, char *argv[])
+{
+  const char *name = "latency";
+
+  for (int i = 1; i < argc; i++)
+  {
+    if      (strcmp(argv[i], "--days") == 0 && i + 1 < argc)    cfg.days = atof(argv[++i]);
+    else if (strcmp(argv[i], "--step") == 0 && i + 1 < argc)    cfg.msStep = strtoul(argv[++i], nullptr, 10);
+    else if (strcmp(argv[i], "--refresh") == 0 && i + 1 < argc) cfg.msRefresh = strtoul(argv[++i], nullptr, 10);
+    else if (strcmp(argv[i], "--zones") == 0 && i + 1 < argc)   cfg.nbrZones = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--max-on") == 0 && i + 1 < argc)  cfg.maxOn = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--spacing") == 0 && i + 1 < argc) cfg.sSpacing = atof(argv[++i]);
+    else if (strcmp(argv[i], "--check-fusion") == 0)            return checkFusion();
+    else if (strcmp(argv[i], "--check-faults") == 0)            return checkFaults();
+    else if (argv[i][0] != '-') name = argv[i];
+    else 
+    { 
+      fprintf(stderr, "usage: %s [scenario] [--days n] [--step ms] [--refresh ms] [--zones n] [--max-on n] [--spacing s] [--check-fusion] [--check-faults]\n", argv[0]); 
+      return 2; 
+    }
+  }
+
+  // The simulated ADC has no noise, a constant room would look stuck
+  FaultParams noStuck = faultParamsNTC;
+  noStuck.nStuck = 0;
+  sensor.getFaultDetector().setParams(noStuck);
+  for (NTCSensor &s : zoneSensors) s.getFaultDetector().setParams(noStuck);
+
+  hostSetAnalogReader(simAdc);
+  heater.setup();
+  thermostat.setup();
+  thermostat.setOnFault(turnHeatingOff);
+  usSim = hostGetMicros();
+  thermostat.setRefreshInterval(cfg.msRefresh);
+  thermostat.enable();
+
+  for (uint8_t i = 0; i < nbrScenarios; i++)
+  {
+    if (strcmp(scenarios[i].name, name) == 0) return scenarios[i].run();
+  }
+  fprintf(stderr, "unknown scenario %s\n", name);
+  return 2;
+}
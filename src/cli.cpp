@@ -14,10 +14,26 @@
  * 
  */
 #include <Arduino.h>
-#include "Thermostat.h"
+#include "ZoneManager.h"
+#include "Profiler.h"
+#include "LoopStats.h"
+#include "Trace.h"
+#include "MemStats.h"
+#include "ChangeReport.h"
+#include "PidLaw.h"
+#include "Autotune.h"
+#include "MpcLaw.h"
+#include "WeeklySchedule.h"
 
-extern Thermostat thermostat;
-extern NTCSensor sensor;
+extern ZoneManager zoneManager;
+extern LoopStats loopStats;
+extern ChangeReport report;
+extern PidLaw pidLaws[];
+extern MpcLaw mpcLaws[];
+extern Autotune autotune;
+extern int8_t zoneTuned;
+extern SwitchPredictor predictors[];
+extern AdaptiveBand bands[];
 
 // Forward declaration of menu actions
 void setLowerLimit();
@@ -25,21 +41,75 @@ void setUpperLimit();
 void setTempDelta();
 void setInterval();
 void setNTCbeta();
+void selectZone();
+void showZones();
+void toggleScanMode();
+void toggleOutputMode();
+void toggleControlLaw();
+void toggleAutotune();
+void togglePredictor();
+void toggleAdaptiveBand();
+void toggleSchedule();
+void showSchedule();
+void setClock();
 void toggleThermostat();
 void showValues();
+void showNoise();
+void resetNoise();
+void toggleChangeReport();
+void requestKeyframe();
 void showMenu();
+void showLoopStats();
+void resetLoopStats();
+void showMemory();
+#ifdef PROFILING
+void showProfile();
+void resetProfile();
+#endif
+#ifdef TRACING
+void dumpTrace();
+void clearTrace();
+#endif
+
+uint8_t zoneSel = 0;   // zone the settings and values apply to
 
 using MenuItem = struct mi{ const char key; const char *txt; void (&action)(); };
 
 MenuItem menu[] = 
 {
+  { 'z', "[z] Select zone          [0..n-1]",     selectZone },
+  { 'Z', "[Z] Show zones",                        showZones },
+  { 'c', "[c] Toggle scan round-robin/all/DMA",   toggleScanMode },
   { 'l', "[l] Set lower limit      [°C]",         setLowerLimit },
   { 'u', "[u] Set upper limit      [°C]",         setUpperLimit },
   { 'd', "[d] Set temp delta       [°C]",         setTempDelta  },
   { 'b', "[b] Set beta of NTC      [°K]",         setNTCbeta },
   { 'i', "[i] Set refresh interval [ms]",         setInterval },
   { 't', "[t] Toggle thermostat enable/disable",  toggleThermostat },
+  { 'o', "[o] Toggle output on-off/time-prop.",   toggleOutputMode },
+  { 'g', "[g] Toggle control hyst./PID/MPC",      toggleControlLaw },
+  { 'a', "[a] Start/stop autotune of PID gains",  toggleAutotune },
+  { 'e', "[e] Toggle switching at limits/early",  togglePredictor },
+  { 'w', "[w] Toggle band fixed/adaptive",        toggleAdaptiveBand },
+  { 'y', "[y] Toggle weekly schedule on/off",     toggleSchedule },
+  { 'Y', "[Y] Show weekly schedule",              showSchedule },
+  { 'T', "[T] Set clock            [d hh mm]",    setClock },
   { 'v', "[v] Show values",                       showValues },
+  { 'n', "[n] Show ADC noise of all zones",       showNoise },
+  { 'N', "[N] Reset ADC noise estimate",          resetNoise },
+  { 'r', "[r] Toggle report changes only/all",    toggleChangeReport },
+  { 'k', "[k] Report all values next refresh",    requestKeyframe },
+  { 'h', "[h] Show loop latency histograms",      showLoopStats },
+  { 'H', "[H] Reset loop latency histograms",     resetLoopStats },
+  { 'm', "[m] Show heap and stack usage",         showMemory },
+#ifdef PROFILING
+  { 'p', "[p] Show profile",                      showProfile },
+  { 'P', "[P] Reset profile",                     resetProfile },
+#endif
+#ifdef TRACING
+  { 'x', "[x] Dump trace",                        dumpTrace },
+  { 'X', "[X] Clear trace",                       clearTrace },
+#endif
   { 'S', "[S] Show menu",                         showMenu },
 };
 constexpr uint8_t nbrMenuItems = sizeof(menu) / sizeof(menu[0]);
@@ -62,6 +132,8 @@ void showMenu()
 
 void doMenu()
 {
+  PROFILE_SCOPE(PRB_DO_MENU);
+  TRACE_SCOPE(TRC_CLI);
   char key = Serial.read();
 
   for (int i = 0; i < nbrMenuItems; i++)
@@ -83,7 +155,7 @@ void setLowerLimit()
   {
     value = Serial.parseFloat();
   }
-  thermostat.setLimitLow(value);
+  zoneManager.getZone(zoneSel).thermostat.setLimitLow(value);
 }
 
 void setUpperLimit()
@@ -95,7 +167,7 @@ void setUpperLimit()
   {
     value = Serial.parseFloat();
   }
-  thermostat.setLimitHigh(value);
+  zoneManager.getZone(zoneSel).thermostat.setLimitHigh(value);
 }
 
 
@@ -108,7 +180,7 @@ void setTempDelta()
   {
     value = Serial.parseFloat();
   }
-  thermostat.setTempDelta(value);
+  zoneManager.getZone(zoneSel).thermostat.setTempDelta(value);
 }
 
 
@@ -121,7 +193,7 @@ void setInterval()
   {
     value = Serial.parseInt();
   }
-  thermostat.setRefreshInterval(value);
+  zoneManager.getZone(zoneSel).thermostat.setRefreshInterval(value);
 }
 
 
@@ -134,7 +206,7 @@ void setNTCbeta()
   {
     value = Serial.parseInt();
   }
-  sensor.setNTCbeta(value);
+  zoneManager.getZone(zoneSel).sensor.setNTCbeta(value);
 }
 
 
@@ -143,12 +215,243 @@ void setNTCbeta()
  */
 void toggleThermostat()
 {
+  Thermostat &thermostat = zoneManager.getZone(zoneSel).thermostat;
   thermostat.isEnabled() ? thermostat.disable() : thermostat.enable();
-  Serial.printf("Thermostat is %s\n", thermostat.isEnabled() ? "enabled" : "disabled");
+  Serial.printf("Thermostat of zone %d is %s\n", zoneSel, thermostat.isEnabled() ? "enabled" : "disabled");
+}
+
+/**
+ * Switch the heater of the zone between on/off with the 
+ * hysteresis of the limits and the time-proportional output
+ */
+void toggleOutputMode()
+{
+  zoneManager.setOutputPwm(zoneSel, ! zoneManager.isOutputPwm(zoneSel));
+  Serial.printf("Output of zone %d is %s\n", zoneSel, zoneManager.isOutputPwm(zoneSel) ? "time-proportional" : "on/off");
+}
+
+/**
+ * Switch the thermostat of the zone from the hysteresis of the limits
+ * to the PID law, from there to the model predictive law and back to
+ * the hysteresis. The laws control to the middle of the limits.
+ */
+void toggleControlLaw()
+{
+  Thermostat &thermostat = zoneManager.getZone(zoneSel).thermostat;
+  IControlLaw *law = thermostat.getControlLaw();
+  if      (law == nullptr)            thermostat.setControlLaw(&pidLaws[zoneSel]);
+  else if (law == &pidLaws[zoneSel])  thermostat.setControlLaw(&mpcLaws[zoneSel]);
+  else                                thermostat.setControlLaw(nullptr);
+  law = thermostat.getControlLaw();
+  Serial.printf("Control of zone %d is %s\n", zoneSel, law ? law->getName() : "hysteresis");
+}
+
+/**
+ * Start the relay autotuning of the PID gains of the zone with a 
+ * hysteresis above the noise of its sensor, or stop a running 
+ * tuning and return to the hysteresis.
+ * When the tuning is done, the zone is switched to its PID 
+ * law with the tuned gains, see checkAutotune()
+ */
+void toggleAutotune()
+{
+  if (zoneTuned >= 0)
+  {
+    autotune.stop();
+    zoneManager.getZone(zoneTuned).thermostat.setControlLaw(nullptr);
+    Serial.printf("Autotune of zone %d stopped\n", zoneTuned);
+    zoneTuned = -1;
+    return;
+  }
+  zoneTuned = zoneSel;
+  autotune.start(zoneManager.getZone(zoneSel).sensor.getNoiseCelsius());
+  zoneManager.getZone(zoneSel).thermostat.setControlLaw(&autotune);
+  Serial.printf("Autotune of zone %d started, hysteresis %.2f °C\n", zoneSel, autotune.getHysteresis());
+}
+
+/**
+ * Let the hysteresis of the zone switch early by the learned 
+ * overshoot and undershoot of the room, or at the limits
+ */
+void togglePredictor()
+{
+  Thermostat &thermostat = zoneManager.getZone(zoneSel).thermostat;
+  thermostat.setPredictor(thermostat.getPredictor() ? nullptr : &predictors[zoneSel]);
+  Serial.printf("Zone %d switches %s\n", zoneSel, thermostat.getPredictor() ? "early by the predicted overshoot" : "at the limits");
+}
+
+/**
+ * Switch the hysteresis of the zone between the fixed delta of the 
+ * limits and a band adapted to the target switching rate
+ */
+void toggleAdaptiveBand()
+{
+  Thermostat &thermostat = zoneManager.getZone(zoneSel).thermostat;
+  thermostat.setAdaptiveBand(thermostat.getAdaptiveBand() ? nullptr : &bands[zoneSel]);
+  Serial.printf("Band of zone %d is %s\n", zoneSel, thermostat.getAdaptiveBand() ? "adaptive" : "fixed");
+}
+
+/**
+ * Let the limits of the zone follow its weekly schedule,
+ * or keep the limits last set
+ */
+void toggleSchedule()
+{
+  WeeklySchedule *schedule = zoneManager.getZone(zoneSel).schedule;
+  if (! schedule) return;
+  schedule->isEnabled() ? schedule->disable() : schedule->enable();
+  Serial.printf("Schedule of zone %d is %s\n", zoneSel, schedule->isEnabled() ? "enabled" : "disabled");
+  if (schedule->isEnabled() && ! WeeklySchedule::isClockSet()) Serial.println("Set the clock with [T]");
+}
+
+void showSchedule()
+{
+  WeeklySchedule::printClock();
+  if (zoneManager.getZone(zoneSel).schedule) zoneManager.getZone(zoneSel).schedule->printSchedule();
+}
+
+/**
+ * Day of the week (0 = Monday), hour and minute
+ * of the clock the schedules follow
+ */
+void setClock()
+{
+  long value[3] = { 0, 0, 0 };
+  uint8_t n = 0;
+
+  delay(2000);
+  while (Serial.available() && n < 3)
+  {
+    value[n++] = Serial.parseInt();
+  }
+  WeeklySchedule::setClock(value[0], value[1], value[2]);
+  WeeklySchedule::printClock();
 }
 
 void showValues()
 {
-  sensor.printData();
-  thermostat.printSettings();
-}
\ No newline at end of file
+  Serial.printf("--- Zone %d %s ---\n", zoneSel, zoneManager.getZone(zoneSel).name);
+  zoneManager.getZone(zoneSel).sensor.printData();
+  zoneManager.getZone(zoneSel).thermostat.printSettings();
+}
+
+/**
+ * Show the noise and the effective number of bits of the 
+ * analog values of every zone, to tune filter and oversampling
+ */
+void showNoise()
+{
+  for (uint8_t z = 0; z < zoneManager.getNbrZones(); z++)
+  {
+    Serial.printf("--- Zone %d %s ---\n", z, zoneManager.getZone(z).name);
+    zoneManager.getZone(z).sensor.printNoise();
+  }
+}
+
+void resetNoise()
+{
+  for (uint8_t z = 0; z < zoneManager.getNbrZones(); z++) zoneManager.getZone(z).sensor.getNoise().reset();
+  Serial.println("ADC noise estimate reset");
+}
+
+/**
+ * Select the zone to which the settings and 
+ * values of the menu apply
+ */
+void selectZone()
+{
+  long value = 0;
+
+  delay(2000);
+  while (Serial.available())
+  {
+    value = Serial.parseInt();
+  }
+  zoneSel = value >= 0 && value < zoneManager.getNbrZones() ? value : zoneSel;
+  Serial.printf("Zone %d %s selected\n", zoneSel, zoneManager.getZone(zoneSel).name);
+}
+
+void showZones()
+{
+  zoneManager.printZones();
+}
+
+void toggleScanMode()
+{
+  static const char * const modeNames[] = { "round-robin", "all channels", "all channels in one DMA pass" };
+  ScanMode mode = zoneManager.getScanMode();
+  zoneManager.setScanMode(mode == SCAN_ROUND_ROBIN ? SCAN_ALL : mode == SCAN_ALL ? SCAN_DMA : SCAN_ROUND_ROBIN);
+  if (zoneManager.getScanMode() == mode) zoneManager.setScanMode(SCAN_ROUND_ROBIN);   // no DMA scan
+  Serial.printf("Scan %s\n", modeNames[zoneManager.getScanMode()]);
+}
+
+/**
+ * Switch between reporting only the changed values
+ * and reporting all values at every refresh
+ */
+void toggleChangeReport()
+{
+  report.isEnabled() ? report.disable() : report.enable();
+  Serial.printf("Report %s\n", report.isEnabled() ? "changes only" : "all values");
+}
+
+void requestKeyframe()
+{
+  report.requestKeyframe();
+}
+
+/**
+ * Show the histograms of loop iteration time and refresh lateness
+ */
+void showLoopStats()
+{
+  loopStats.print();
+}
+
+void resetLoopStats()
+{
+  loopStats.reset();
+  Serial.println("Loop latency histograms reset");
+}
+
+/**
+ * Show free heap, heap blocks allocated after setup()
+ * and the stack high-water mark of the tasks
+ */
+void showMemory()
+{
+  MemStats::printMemory();
+}
+
+#ifdef PROFILING
+/**
+ * Show min, mean and max cycles of the profiling probes
+ */
+void showProfile()
+{
+  Profiler::printProfile();
+}
+
+void resetProfile()
+{
+  Profiler::reset();
+  Serial.println("Profile reset");
+}
+#endif
+
+#ifdef TRACING
+/**
+ * Dump the trace ring, convert the output with
+ * tools/trace2chrome.py for a trace viewer
+ */
+void dumpTrace()
+{
+  Trace::dump();
+}
+
+void clearTrace()
+{
+  Trace::clear();
+  Serial.println("Trace cleared");
+}
+#endif
@@ -44,13 +44,26 @@
  */
 
 #include <Arduino.h>
-#include "Thermostat.h"
+#include "ZoneManager.h"
+#include "LoopStats.h"
+#include "Trace.h"
+#include "MemStats.h"
+#include "TokenLog.h"
+#include "ChangeReport.h"
+#include "PidLaw.h"
+#include "Autotune.h"
+#include "MpcLaw.h"
+#include "WeeklySchedule.h"
 
 #define PIN_THERMOSTAT  GPIO_NUM_4   // pin to turn on/off the heating
 #define PIN_HEARTBEAT   LED_BUILTIN  // indicates normal operation with 1 beat/sec 
 #define PIN_ADC         GPIO_NUM_34
 
-extern void heartbeat(uint8_t pin, uint8_t nBeats, uint8_t t, uint8_t duty);
+#ifndef NBR_ZONES
+  #define NBR_ZONES     1            // number of zones wired, up to 4
+#endif
+
+extern void heartbeat(IActuator &led, uint8_t nBeats, uint8_t t, uint8_t duty);
 extern void doMenu();
 extern void setLowerLimit();
 extern void setUpperLimit();
@@ -59,13 +72,14 @@ extern void setInterval();
 extern void toggleThermostat();
 extern void showValues();
 extern void showMenu();
-
-bool heatingIsOn = false; 
+extern void printTelemetry();
 
 // Forward declaration of the handler functions for the thermostat
 void processData();
-void turnHeatingOn();
-void turnHeatingOff();
+void onSwitch(uint8_t zone, bool on);
+void frostAlarmOn();
+void frostAlarmOff();
+void frostSensorFault();
 
 //                       Rs     Ro    beta     
 ParamsNTC ntcRs10k  = { 10000, 10000, 2800 };
@@ -76,55 +90,209 @@ ParamsADC adcEsp32_2_5 = { PIN_ADC, true, 4095, ADC_2_5db, 3300.0, 1300.0,  65.0
 ParamsADC adcEsp32_6   = { PIN_ADC, true, 4095, ADC_6db,   3300.0, 1800.0,  90.0 };
 ParamsADC adcEsp32_11  = { PIN_ADC, true, 4095, ADC_11db,  3300.0, 3200.0, 130.0 };
 
-SensorData sensorData; // holds measured and calculated sensor values (see SensorData.h)
-NTCSensor  sensor(ntcRs10k, adcEsp32_11, sensorData); // sensor used for thermostat
-Thermostat thermostat(sensor, processData, turnHeatingOn, turnHeatingOff);
+// ADC channels of the zones, zone 0 uses PIN_ADC
+ParamsADC adcZone[] = 
+{
+  { PIN_ADC,     true, 4095, ADC_11db,  3300.0, 3200.0, 130.0 },
+  { GPIO_NUM_35, true, 4095, ADC_11db,  3300.0, 3200.0, 130.0 },
+  { GPIO_NUM_32, true, 4095, ADC_11db,  3300.0, 3200.0, 130.0 },
+  { GPIO_NUM_33, true, 4095, ADC_11db,  3300.0, 3200.0, 130.0 },
+};
+
+SensorData sensorData[4]; // holds measured and calculated sensor values (see SensorData.h)
+NTCSensor  sensors[] = 
+{ 
+  { ntcRs10k, adcZone[0], sensorData[0] }, 
+  { ntcRs10k, adcZone[1], sensorData[1] }, 
+  { ntcRs10k, adcZone[2], sensorData[2] }, 
+  { ntcRs10k, adcZone[3], sensorData[3] }, 
+};
+Thermostat thermostats[] =
+{
+  { sensors[0], processData, zoneIdle, zoneIdle },
+  { sensors[1], zoneIdle,    zoneIdle, zoneIdle },
+  { sensors[2], zoneIdle,    zoneIdle, zoneIdle },
+  { sensors[3], zoneIdle,    zoneIdle, zoneIdle },
+};
+uint8_t adcZonePins[] = { PIN_ADC, GPIO_NUM_35, GPIO_NUM_32, GPIO_NUM_33 };
+AdcScan adcScan(adcZonePins, NBR_ZONES, ADC_11db);   // all zone channels in one DMA pass
+
+// The sample of zone 0 is also evaluated by a frost alarm
+SensorPublisher publisher0(sensors[0]);
+Thermostat frostAlarm(sensors[0], zoneIdle, frostAlarmOn, frostAlarmOff);
+bool       frostAlarmIsOn = false;
+
+// PID and model predictive control laws of the zones, used instead of the hysteresis when selected with [g]
+PidLaw pidLaws[4];
+MpcLaw mpcLaws[4];
+
+// Predictors of the overshoot of the zones, used by the hysteresis when selected with [e]
+SwitchPredictor predictors[4];
+
+// Bands of the hysteresis adapted to 2 switch cycles per hour, used when selected with [w]
+AdaptiveBand bands[4];
 
-// Called when refresh intervall expires
+// Relay autotuning of the PID gains of one zone at a time, started with [a]
+Autotune autotune;
+int8_t   zoneTuned = -1;   // -1 if no tuning runs
+
+// Weekly schedules of the limits, stored per zone, followed when enabled with [y] and the clock set with [T]
+ScheduleSlot scheduleOffice[] =
+{ //  days               h   m   low  high  (°C x 2)
+  { SCHEDULE_WORKDAYS,   6, 30,  40,  44 },   // 20..22 °C from 06:30
+  { SCHEDULE_WORKDAYS,  18,  0,  32,  36 },   // 16..18 °C from 18:00
+  { SCHEDULE_WEEKEND,    0,  0,  32,  36 },
+};
+WeeklySchedule schedules[4];
+
+// Heating outputs of the zones, switched together in one register write per tick
+GpioBatch  heaterBatch;
+GpioOutput heaters[] =
+{
+  { PIN_THERMOSTAT, &heaterBatch },
+  { GPIO_NUM_16,    &heaterBatch },
+  { GPIO_NUM_17,    &heaterBatch },
+  { GPIO_NUM_18,    &heaterBatch },
+};
+GpioOutput led(PIN_HEARTBEAT);
+
+// Time-proportional outputs of the SSRs with 10 s windows, off until selected with [o]
+SlowPwm pwms[] = 
+{ 
+  { heaters[0], 10000 }, 
+  { heaters[1], 10000 }, 
+  { heaters[2], 10000 }, 
+  { heaters[3], 10000 },
+};
+
+//             name      sensor      thermostat      heating output
+Zone zones[] =
+{
+  { "Living",  sensors[0], thermostats[0], heaters[0], false, &publisher0, &pwms[0], &schedules[0] },
+  { "Kitchen", sensors[1], thermostats[1], heaters[1], false, nullptr,     &pwms[1], &schedules[1] },
+  { "Bedroom", sensors[2], thermostats[2], heaters[2], false, nullptr,     &pwms[2], &schedules[2] },
+  { "Office",  sensors[3], thermostats[3], heaters[3], false, nullptr,     &pwms[3], &schedules[3] },
+};
+SwitchCoordinator coordinator(2, 30000);  // at most 2 heaters on, 30 s between switch ons
+static_assert(NBR_ZONES >= 1 && NBR_ZONES <= sizeof(zones) / sizeof(zones[0]), "NBR_ZONES out of range");
+static_assert(NBR_ZONES <= COORD_MAX_ZONES, "more zones than the coordinator takes");
+ZoneManager zoneManager(zones, NBR_ZONES, onSwitch);
+LoopStats  loopStats;  // loop iteration and refresh lateness histograms
+ChangeReport report(30);  // print only changed values, all of them every 30 reports
+
+// Called when refresh intervall of zone 0 expires, 
+// the zone manager has already sampled the sensor
 void processData()
 {
-  sensor.readSensor();
-  sensor.printParams();
-  sensor.printData();
-  thermostat.printSettings(); 
+  loopStats.recordLateness(thermostats[0].getLateness());
+  report.begin();
+  sensors[0].reportParams(report);
+  sensors[0].reportData(report);
+  thermostats[0].reportSettings(report);
+#ifdef TELEMETRY
+  printTelemetry();
+#endif
+}
+
+// Called by the zone manager after the heating of a zone has been switched
+void onSwitch(uint8_t zone, bool on)
+{
+  if (on) TLOG_I("===> zone %d switch on heating", zone);
+  else    TLOG_I("===> zone %d switch off heating", zone);
+  loopStats.recordActuation(micros() - zones[zone].thermostat.getSampleTime());
 }
 
-// Called as onLowTemp() when the temperature falls below the set limit
-void turnHeatingOn()
+// Called by the frost alarm when zone 0 falls below 3 °C
+void frostAlarmOn()
 {
-  if (! heatingIsOn)
+  if (! frostAlarmIsOn)
   {
-    log_i("===> switch on heating, it is: %s", heatingIsOn ? "on" : "off");
-    digitalWrite(PIN_THERMOSTAT, HIGH);
-    heatingIsOn = true;
+    TLOG_I("===> frost alarm in zone 0");
+    frostAlarmIsOn = true;
   }
 }
 
-// Called as onHighTemp() when the temperature rises above the set limit
-void turnHeatingOff()
+// Called when zone 0 has risen above 5 °C again
+void frostAlarmOff()
 {
-  if (heatingIsOn)
+  if (frostAlarmIsOn)
   {
-  log_i("===> switch off heating, it is: %s", heatingIsOn ? "on" : "off");
-  digitalWrite(PIN_THERMOSTAT, LOW);
-  heatingIsOn = false;
+    TLOG_I("===> frost alarm cleared");
+    frostAlarmIsOn = false;
   }
 }
 
+// Called when the sensor of zone 0 becomes faulty, the state of
+// the frost alarm is kept since the temperature is unknown
+void frostSensorFault()
+{
+  TLOG_I("===> frost alarm sensor fault in zone 0");
+}
+
 
 void initOutputPins()
 {
-  pinMode(PIN_HEARTBEAT, OUTPUT);
-  pinMode(PIN_THERMOSTAT, OUTPUT);
-  digitalWrite(PIN_THERMOSTAT, LOW);
+  led.setup();
   log_i("==> done");  
 }
 
 
-void initThermostat()
+// Hand the zone over to its PID law with the tuned gains, 
+// which are stored, or back to the hysteresis if the tuning failed.
+// A tuning whose law has been replaced, e.g. with [g], is aborted.
+void checkAutotune()
 {
-  thermostat.setup();
-  thermostat.enable();
+  if (zoneTuned < 0) return;
+  Thermostat &thermostat = zones[zoneTuned].thermostat;
+  if (thermostat.getControlLaw() != &autotune)
+  {
+    autotune.stop();
+    TLOG_I("===> autotune of zone %d aborted", zoneTuned);
+    zoneTuned = -1;
+    return;
+  }
+  if (autotune.getState() == TUNE_RUNNING) return;
+  if (autotune.getState() == TUNE_DONE)
+  {
+    char key[12];
+    snprintf(key, sizeof(key), "zone%d", zoneTuned);
+    pidLaws[zoneTuned].setParams(autotune.getParams());
+    if (! pidLaws[zoneTuned].save(key)) log_w("gains of zone %d not stored", zoneTuned);
+    thermostat.setControlLaw(&pidLaws[zoneTuned]);
+    TLOG_I("===> zone %d tuned", zoneTuned);
+  }
+  else
+  {
+    thermostat.setControlLaw(nullptr);
+    TLOG_I("===> autotune of zone %d failed", zoneTuned);
+  }
+  zoneTuned = -1;
+}
+
+
+void initZones()
+{
+  char key[12];
+  for (uint8_t z = 0; z < NBR_ZONES; z++)
+  {
+    snprintf(key, sizeof(key), "zone%d", z);
+    pidLaws[z].load(key);   // tuned gains, if any
+    if (! schedules[z].load(key))
+    {
+      schedules[z].setSlots(scheduleOffice, sizeof(scheduleOffice) / sizeof(scheduleOffice[0]));
+      if (! schedules[z].save(key)) log_w("schedule of zone %d not stored", z);
+    }
+  }
+  zoneManager.setAdcScan(adcScan);
+  zoneManager.setCoordinator(coordinator);
+  zoneManager.setGpioBatch(heaterBatch);
+  delay(1000);              // let the NTC inputs configured by the sensors settle, once for all zones
+  zoneManager.setup();
+  frostAlarm.setTempDelta(2.0);
+  frostAlarm.setLimitLow(3.0);
+  frostAlarm.setOnFault(frostSensorFault);
+  frostAlarm.enable();
+  publisher0.subscribe(frostAlarm);
   log_i("==> done");
 }
 
@@ -134,13 +302,20 @@ void setup()
   Serial.begin(115200);
 
   initOutputPins(); 
-  initThermostat();
+  initZones();
   showMenu();
+  MemStats::markSteadyState();  // no heap allocation from here on
 }
 
 void loop() 
 {
+  loopStats.tick(micros());
+  TRACE_SCOPE(TRC_LOOP);
   if(Serial.available()) doMenu();
-  thermostat.loop();
-  heartbeat(PIN_HEARTBEAT, 1, 1, 5);
+  zoneManager.loop();
+  checkAutotune();
+  heartbeat(led, 1, 1, 5);
+#ifdef TOKENIZED_LOG
+  TokenLog::drain(1);
+#endif
 }
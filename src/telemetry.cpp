@@ -0,0 +1,51 @@
+/**
+ * Program      Telemetry of the thermostat
+ *
+ * Author       2026-10-17 agent
+ *
+ * Purpose      Prints one JSON line per refresh with the measured temperature,
+ *              the state of the heating and the loop latency statistics, so
+ *              that the values can be logged and evaluated on a host.
+ *
+ * Remarks      Only compiled in when TELEMETRY is defined in the build flags.
+ *
+ *              ms       time since start
+ *              tc       temperature of zone 0 in °C
+ *              on       heating of zone 0 is on (1) or off (0)
+ *              zones    [tc, on, sigma, enob] of every zone, sigma is the noise
+ *                       of the analog value in LSB, enob the effective number
+ *                       of bits at the attenuation of the zones ADC
+ *              it50     median of loop iteration time in µs (bucket upper bound)
+ *              it99     99th percentile of loop iteration time in µs
+ *              itmax    maximum loop iteration time in µs
+ *              late99   99th percentile of refresh lateness in ms
+ *              latemax  maximum refresh lateness in ms
+ */
+#include <Arduino.h>
+#include "ZoneManager.h"
+#include "LoopStats.h"
+
+#ifdef TELEMETRY
+
+extern ZoneManager zoneManager;
+extern LoopStats   loopStats;
+
+void printTelemetry()
+{
+  const LogHistogram &it   = loopStats.getIteration();
+  const LogHistogram &late = loopStats.getLateness();
+  Zone &zone0 = zoneManager.getZone(0);
+  Serial.printf("{\"ms\":%u,\"tc\":%.2f,\"on\":%d,\"it50\":%u,\"it99\":%u,\"itmax\":%u,\"late99\":%u,\"latemax\":%u,\"zones\":[",
+                (unsigned)millis(), zone0.sensor.getCelsius(), zone0.heatingIsOn ? 1 : 0,
+                (unsigned)it.percentile(0.5f), (unsigned)it.percentile(0.99f), (unsigned)it.getMax(),
+                (unsigned)late.percentile(0.99f), (unsigned)late.getMax());
+  for (uint8_t z = 0; z < zoneManager.getNbrZones(); z++)
+  {
+    Zone &zone = zoneManager.getZone(z);
+    Serial.printf("%s[%.2f,%d,%.2f,%.2f]", z ? "," : "", zone.sensor.getCelsius(), zone.heatingIsOn ? 1 : 0,
+                  zone.sensor.getNoiseSigma(), zone.sensor.getEnob());
+  }
+  Serial.print("]}\n");
+}
+
+#endif
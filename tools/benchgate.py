@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+"""
+Performance regression gate for the host benchmarks
+
+Runs the benchmark program several times, keeps the best median of each
+benchmark and compares it with the baseline checked in as
+bench/baseline.json. A benchmark regresses when its median exceeds
+
+    baseline median * (1 + tolerance) + k * noise
+
+where noise is the spread (p90 - p10) / 2.56 of the noisier of both runs,
+i.e. an estimate of the standard deviation of a batch. The gate prints a
+report and exits with 1 if any benchmark regressed.
+
+Usage   pio run -e native_bench
+        python tools/benchgate.py                 compare with the baseline
+        python tools/benchgate.py --update        store the results as new baseline
+        python tools/benchgate.py --results r.json   compare saved results
+"""
+import argparse
+import json
+import os
+import platform
+import subprocess
+import sys
+
+DEFAULT_BENCH    = os.path.join(".pio", "build", "native_bench", "program")
+DEFAULT_BASELINE = os.path.join("bench", "baseline.json")
+
+
+def run_bench(bench, runs, reps):
+    """Return the best result per benchmark name over several runs"""
+    best = {}
+    for _ in range(runs):
+        out = subprocess.run([bench, "--json", "--reps", str(reps)], check=True,
+                             capture_output=True, text=True).stdout
+        for r in json.loads(out):
+            if r["name"] not in best or r["median"] < best[r["name"]]["median"]:
+                best[r["name"]] = r
+    return best
+
+
+def noise(r):
+    return (r["p90"] - r["p10"]) / 2.56
+
+
+def compare(baseline, results, tolerance, k):
+    """Return the report lines and the number of regressions"""
+    lines = ["%-26s %10s %10s %8s %10s %12s  %s" % ("benchmark", "base", "new", "delta", "limit", "ops/s", "status")]
+    regressions = 0
+    for name in sorted(set(baseline) | set(results)):
+        base, new = baseline.get(name), results.get(name)
+        if new is None:
+            lines.append("%-26s %10.1f %10s %8s %10s %12s  missing" % (name, base["median"], "-", "-", "-", "-"))
+            continue
+        rate = 1e9 / new["median"] if new["median"] > 0 else 0
+        if base is None:
+            lines.append("%-26s %10s %10.1f %8s %10s %12.0f  new" % (name, "-", new["median"], "-", "-", rate))
+            continue
+        limit = base["median"] * (1 + tolerance) + k * max(noise(base), noise(new))
+        delta = (new["median"] - base["median"]) / base["median"] * 100
+        if new["median"] > limit:
+            status = "REGRESSED"
+            regressions += 1
+        elif delta < -tolerance * 100:
+            status = "improved"
+        else:
+            status = "ok"
+        lines.append("%-26s %10.1f %10.1f %+7.1f%% %10.1f %12.0f  %s" %
+                     (name, base["median"], new["median"], delta, limit, rate, status))
+    return lines, regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--bench", default=DEFAULT_BENCH, help="benchmark program")
+    parser.add_argument("--baseline", default=DEFAULT_BASELINE, help="baseline file")
+    parser.add_argument("--results", help="JSON output of the benchmark program instead of running it")
+    parser.add_argument("--runs", type=int, default=3, help="runs of the program, the best median counts")
+    parser.add_argument("--reps", type=int, default=51, help="timed batches per benchmark and run")
+    parser.add_argument("--tolerance", type=float, default=0.10, help="relative tolerance (default 0.10)")
+    parser.add_argument("-k", type=float, default=2.0, help="allowed multiples of the noise (default 2)")
+    parser.add_argument("--update", action="store_true", help="store the results as new baseline")
+    args = parser.parse_args()
+
+    if args.results:
+        with open(args.results) as f:
+            results = {r["name"]: r for r in json.load(f)}
+    else:
+        results = run_bench(args.bench, args.runs, args.reps)
+
+    if args.update:
+        keep = ("unit", "median", "p10", "p90", "p99")
+        data = {
+            "host": platform.machine() + " " + platform.system(),
+            "benchmarks": {n: {key: r[key] for key in keep} for n, r in sorted(results.items())},
+        }
+        with open(args.baseline, "w") as f:
+            json.dump(data, f, indent=2)
+            f.write("\n")
+        print("baseline %s updated with %d benchmarks" % (args.baseline, len(results)))
+        return 0
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)["benchmarks"]
+    lines, regressions = compare(baseline, results, args.tolerance, args.k)
+    print("\n".join(lines))
+    if regressions:
+        print("\n%d benchmark(s) regressed against %s" % (regressions, args.baseline))
+        return 1
+    print("\nno regression against %s" % args.baseline)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,179 @@
+#!/usr/bin/env python3
+"""
+Static memory footprint per component from the linker map file
+
+Attributes the size of every input section of the linked firmware to a
+component and within the component to a class or symbol:
+
+  component   src/<file> for the sources in src, the library name for the
+              project libraries in lib, 'framework' for everything else
+  class       the class of a member function or static member, the name
+              of a free function or global variable, '<strings>' for
+              string literals such as the printf format strings
+
+Flash counts code, constants and the initial values of initialized data,
+RAM counts initialized data, zeroed data (bss) and code placed in IRAM.
+
+Usage   python tools/memreport.py firmware.map [--state memreport.json] [--detail] [--all]
+
+With --state the report of the previous build is read from the file, the
+differences are shown and the file is updated with the current report.
+The PlatformIO target 'memreport' (pio run -t memreport) does this for
+the current build, see tools/pio_memreport.py.
+"""
+import argparse
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+
+SKIP = (".debug", ".comment", ".note", ".xt.", ".xtensa", ".stab", ".gnu", ".ARM.attributes")
+RAM_ONLY = (".bss", ".sbss", "COMMON", ".noinit", ".dram0.bss")
+RAM_AND_FLASH = (".data", ".sdata", ".dram", ".iram", ".rtc.data")
+
+PREFIXES = (".text.", ".literal.", ".rodata.", ".data.", ".bss.", ".sdata.", ".sbss.", ".iram1.",
+            ".dram1.", ".data.rel.ro.local.", ".data.rel.ro.", ".data.rel.local.", ".data.rel.")
+
+INPUT_SECTION = re.compile(r"^ (\.\S+|COMMON)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+SECTION_NAME = re.compile(r"^ (\.\S+|COMMON)$")
+SECTION_REST = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+
+
+def parse_map(lines):
+    """Yield (section name, size, object) of the allocated input sections"""
+    started = False
+    pending = None
+    for line in lines:
+        line = line.rstrip("\n")
+        if not started:
+            started = line.startswith("Linker script and memory map")
+            continue
+        if pending:
+            m = SECTION_REST.match(line)
+            if m:
+                yield pending, int(m.group(2), 16), m.group(3)
+            pending = None
+            continue
+        m = INPUT_SECTION.match(line)
+        if m:
+            yield m.group(1), int(m.group(3), 16), m.group(4)
+            continue
+        m = SECTION_NAME.match(line)
+        if m:
+            pending = m.group(1)
+
+
+def component_of(obj):
+    """Map the object file of a section to a component"""
+    obj = obj.replace("\\", "/")
+    m = re.search(r"/lib[^/]*/lib(\w+)\.a\(", obj)
+    if m and "/.pio/" in "/" + obj and "FrameworkArduino" not in obj:
+        return m.group(1)
+    m = re.search(r"/src/(.+?)\.(?:cpp|c|S)\.o$", obj)
+    if m:
+        return "src/" + m.group(1)
+    return "framework"
+
+
+def symbol_of(section):
+    """Return the (mangled) symbol of a section built with -ffunction-sections/-fdata-sections"""
+    if ".str1." in section or section.startswith(".rodata.str"):
+        return "<strings>"
+    if section.startswith(".rodata.cst"):
+        return "<constants>"
+    for prefix in sorted(PREFIXES, key=len, reverse=True):
+        if section.startswith(prefix):
+            symbol = section[len(prefix):]
+            return re.sub(r"^(startup|unlikely|hot|exit)\.", "", symbol)
+    return "<" + section.lstrip(".") + ">"
+
+
+def demangle(names):
+    tool = shutil.which("xtensa-esp32-elf-c++filt") or shutil.which("c++filt")
+    names = list(names)
+    if not tool or not names:
+        return {n: n for n in names}
+    out = subprocess.run([tool], input="\n".join(names), capture_output=True, text=True).stdout.splitlines()
+    return dict(zip(names, out)) if len(out) == len(names) else {n: n for n in names}
+
+
+def class_of(symbol):
+    """NTCSensor::readSensor() -> NTCSensor, guard variables and vtables to their class"""
+    if symbol.startswith("<"):
+        return symbol
+    symbol = re.sub(r"^(vtable for|typeinfo for|typeinfo name for|guard variable for) ", "", symbol)
+    symbol = re.sub(r"\(.*$", "", symbol)
+    symbol = re.sub(r"<.*>", "<>", symbol)
+    symbol = symbol.split()[-1] if symbol.split() else symbol   # drop the return type of templates
+    parts = symbol.split("::")
+    return "::".join(parts[:-1]) if len(parts) > 1 else symbol
+
+
+def build_report(lines):
+    sections = [(s, size, obj) for s, size, obj in parse_map(lines) if size and not s.startswith(SKIP)]
+    names = demangle({symbol_of(s) for s, _, _ in sections})
+    report = {}
+    for s, size, obj in sections:
+        comp = report.setdefault(component_of(obj), {"flash": 0, "ram": 0, "classes": {}})
+        cls = comp["classes"].setdefault(class_of(names[symbol_of(s)]), {"flash": 0, "ram": 0})
+        ram   = size if s.startswith(RAM_ONLY + RAM_AND_FLASH) else 0
+        flash = 0 if s.startswith(RAM_ONLY) else size
+        for entry in (comp, cls):
+            entry["flash"] += flash
+            entry["ram"] += ram
+    return report
+
+
+def delta(now, before):
+    return "" if before is None else "%+d" % (now - before)
+
+
+def print_report(report, previous, detail, show_all):
+    fmt = "%-34s %9s %8s %9s %8s"
+    print(fmt % ("component / class", "flash", "delta", "ram", "delta"))
+    for name in sorted(report, key=lambda n: -(report[n]["flash"] + report[n]["ram"])):
+        comp, old = report[name], previous.get(name)
+        print(fmt % (name, comp["flash"], delta(comp["flash"], old and old["flash"]),
+                     comp["ram"], delta(comp["ram"], old and old["ram"])))
+        if not detail or (name == "framework" and not show_all):
+            continue
+        classes = comp["classes"]
+        for cls in sorted(classes, key=lambda c: -(classes[c]["flash"] + classes[c]["ram"])):
+            c, o = classes[cls], old and old["classes"].get(cls)
+            print(fmt % ("  " + cls[:32], c["flash"], delta(c["flash"], o and o["flash"]),
+                         c["ram"], delta(c["ram"], o and o["ram"])))
+    for name in sorted(set(previous) - set(report)):
+        print(fmt % (name, 0, delta(0, previous[name]["flash"]), 0, delta(0, previous[name]["ram"])))
+    total_flash = sum(c["flash"] for c in report.values())
+    total_ram = sum(c["ram"] for c in report.values())
+    print(fmt % ("total", total_flash, delta(total_flash, sum(c["flash"] for c in previous.values()) if previous else None),
+                 total_ram, delta(total_ram, sum(c["ram"] for c in previous.values()) if previous else None)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("map", help="linker map file")
+    parser.add_argument("--state", help="report of the previous build, updated with the current one")
+    parser.add_argument("--detail", action="store_true", help="list the classes and symbols of each component")
+    parser.add_argument("--all", action="store_true", help="list the classes of the framework as well")
+    args = parser.parse_args()
+
+    with open(args.map, encoding="utf-8", errors="replace") as f:
+        report = build_report(f)
+    if not report:
+        sys.exit("no sections found in %s, is it a GNU ld map file?" % args.map)
+
+    previous = {}
+    if args.state and os.path.exists(args.state):
+        with open(args.state) as f:
+            previous = json.load(f)
+    print_report(report, previous, args.detail, args.all)
+    if args.state:
+        with open(args.state, "w") as f:
+            json.dump(report, f, indent=1, sort_keys=True)
+
+
+if __name__ == "__main__":
+    main()
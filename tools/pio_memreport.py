@@ -0,0 +1,22 @@
+"""
+PlatformIO extra script adding the target 'memreport'
+
+    pio run -t memreport
+
+builds the firmware and prints the flash and RAM usage per component
+(tools/memreport.py) with the difference to the previous report, which
+is kept in the build directory. The map file is written by the linker
+flag -Wl,-Map in platformio.ini.
+"""
+Import("env")
+
+env.AddCustomTarget(
+    name="memreport",
+    dependencies="$BUILD_DIR/${PROGNAME}.elf",
+    actions=[
+        '"$PYTHONEXE" "$PROJECT_DIR/tools/memreport.py" "$BUILD_DIR/firmware.map" '
+        '--state "$BUILD_DIR/memreport.json" --detail'
+    ],
+    title="Memory report",
+    description="Flash and RAM usage per component and class, difference to the previous build",
+)
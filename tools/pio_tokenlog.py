@@ -0,0 +1,22 @@
+"""
+PlatformIO extra script writing the table of the tokenized log formats
+
+At every build the sources in src and lib are scanned for TLOG() calls and
+the table of format strings is written to $BUILD_DIR/tokens.json, so it
+always matches the firmware. Decode a monitor log with
+
+    python tools/tokenlog.py decode monitor.log --table .pio/build/<env>/tokens.json
+"""
+import os
+import subprocess
+import sys
+
+Import("env")
+
+if "-DTOKENIZED_LOG" in env.get("BUILD_FLAGS", []) or "TOKENIZED_LOG" in str(env.get("CPPDEFINES", [])):
+    build_dir = env.subst("$BUILD_DIR")
+    project_dir = env.subst("$PROJECT_DIR")
+    os.makedirs(build_dir, exist_ok=True)
+    subprocess.check_call([sys.executable, os.path.join(project_dir, "tools", "tokenlog.py"), "table",
+                           os.path.join(project_dir, "src"), os.path.join(project_dir, "lib"),
+                           "-o", os.path.join(build_dir, "tokens.json")])
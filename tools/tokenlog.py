@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+"""
+Host side of the tokenized logging (see lib/TokenLog/TokenLog.h)
+
+  table    scans the sources for TLOG() and TLOG_I() calls and writes the
+           table of format strings with their tokens as JSON, fails if two
+           formats have the same token
+  decode   renders the '~' hex records of a monitor log with the table,
+           all other lines are passed through unchanged
+
+Usage   python tools/tokenlog.py table src lib -o tokens.json
+        python tools/tokenlog.py decode monitor.log --table tokens.json
+        pio device monitor | python tools/tokenlog.py decode - --sources src lib
+
+The token of a format is the 32 bit FNV-1a hash of its UTF-8 bytes, the
+same as computed by tokenOf() on the device. A record is
+token (4) | millis (4) | nbr of args (1) | args (4 each), little endian.
+"""
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+
+CALL = re.compile(r"\bTLOG(_I)?\s*\(")
+CONVERSION = re.compile(r"%[-+ #0]*\d*(?:\.\d+)?(?:hh|h|ll|l|z)?([diouxXcfeEgGs%])")
+ESCAPES = {"n": "\n", "t": "\t", "r": "\r", "0": "\0", "\\": "\\", '"': '"', "'": "'", "?": "?"}
+
+
+def token_of(fmt):
+    h = 2166136261
+    for b in fmt.encode("utf-8"):
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def unescape(body):
+    out, i = [], 0
+    while i < len(body):
+        c = body[i]
+        if c != "\\":
+            out.append(c)
+            i += 1
+        elif body[i + 1] == "x":
+            m = re.match(r"[0-9a-fA-F]+", body[i + 2:])
+            out.append(chr(int(m.group(0), 16)))
+            i += 2 + len(m.group(0))
+        else:
+            out.append(ESCAPES.get(body[i + 1], body[i + 1]))
+            i += 2
+    return "".join(out)
+
+
+def literals_at(text, pos):
+    """Return the concatenation of the adjacent string literals starting at pos or None"""
+    parts = []
+    while True:
+        m = re.compile(r'\s*(?:R"([^(\s]*)\(|")').match(text, pos)
+        if not m:
+            break
+        if m.group(0).rstrip().endswith("("):
+            end = text.index(")" + m.group(1) + '"', m.end())
+            parts.append(text[m.end():end])
+            pos = end + len(m.group(1)) + 2
+        else:
+            s = re.compile(r'((?:[^"\\\n]|\\.)*)"').match(text, m.end())
+            parts.append(unescape(s.group(1)))
+            pos = s.end()
+    return "".join(parts) if parts else None
+
+
+def scan(paths):
+    """Return {token: format} of all TLOG calls in the sources below paths,
+    exit with 1 if two different formats have the same token"""
+    table = {}
+    origin = {}
+    collisions = 0
+    for path in paths:
+        for root, _, files in os.walk(path):
+            for name in sorted(files):
+                if not name.endswith((".cpp", ".h", ".c", ".ino")):
+                    continue
+                file = os.path.join(root, name)
+                with open(file, encoding="utf-8", errors="replace") as f:
+                    text = f.read()
+                for m in CALL.finditer(text):
+                    fmt = literals_at(text, m.end())
+                    if fmt is None:
+                        continue
+                    if m.group(1):
+                        fmt = "[I] " + fmt + "\n"
+                    token = "%08x" % token_of(fmt)
+                    where = "%s:%d" % (file, text.count("\n", 0, m.start()) + 1)
+                    if token in table and table[token] != fmt:
+                        print("token %s collision:\n  %s %r\n  %s %r" % (token, origin[token], table[token], where, fmt),
+                              file=sys.stderr)
+                        collisions += 1
+                        continue
+                    table[token] = fmt
+                    origin.setdefault(token, where)
+    if collisions:
+        print("%d token collisions, reword one of the formats" % collisions, file=sys.stderr)
+        sys.exit(1)
+    return table
+
+
+def render(fmt, raw_args):
+    args = []
+    for conv, raw in zip([c for c in CONVERSION.findall(fmt) if c != "%"], raw_args):
+        if conv in "fFeEgG":
+            args.append(struct.unpack("<f", raw)[0])
+        elif conv in "di":
+            args.append(struct.unpack("<i", raw)[0])
+        else:
+            args.append(struct.unpack("<I", raw)[0])
+    fmt = CONVERSION.sub(lambda m: m.group(0).replace("hh", "").replace("ll", "").replace("l", "")
+                         .replace("h", "").replace("z", "").replace("u", "d"), fmt)
+    try:
+        return fmt % tuple(args)
+    except (TypeError, ValueError):
+        return fmt + " <bad arguments>\n"
+
+
+def decode(lines, table, out, timestamps):
+    for line in lines:
+        s = line.strip()
+        if not re.fullmatch(r"~(?:[0-9a-f]{2}){9,}", s):
+            out.write(line)
+            continue
+        rec = bytes.fromhex(s[1:])
+        token, ms, n = struct.unpack("<IIB", rec[:9])
+        raw_args = [rec[9 + 4 * i: 13 + 4 * i] for i in range(n)]
+        fmt = table.get("%08x" % token)
+        text = render(fmt, raw_args) if fmt is not None else "<unknown token %08x>\n" % token
+        if timestamps:
+            text = "[%10.3f] %s" % (ms / 1000.0, text)
+        out.write(text)
+        out.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="command", required=True)
+    t = sub.add_parser("table", help="extract the format strings from the sources")
+    t.add_argument("sources", nargs="+", help="source directories")
+    t.add_argument("-o", "--output", help="output file, default stdout")
+    d = sub.add_parser("decode", help="render the records of a monitor log")
+    d.add_argument("log", help="monitor log, - for stdin")
+    d.add_argument("--table", help="table written by the command table")
+    d.add_argument("--sources", nargs="+", default=["src", "lib"], help="scan these directories if no table is given")
+    d.add_argument("--timestamps", action="store_true", help="prefix the messages with the time in s")
+    args = parser.parse_args()
+
+    if args.command == "table":
+        table = scan(args.sources)
+        out = open(args.output, "w") if args.output else sys.stdout
+        json.dump(table, out, indent=1, sort_keys=True, ensure_ascii=False)
+        out.write("\n")
+        return
+    if args.table:
+        with open(args.table, encoding="utf-8") as f:
+            table = json.load(f)
+    else:
+        table = scan(args.sources)
+    log = sys.stdin if args.log == "-" else open(args.log, encoding="utf-8", errors="replace")
+    decode(log, table, sys.stdout, args.timestamps)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""
+Converts the trace dump of the thermostat (CLI command x) to the Chrome
+trace_event JSON format, which can be opened in chrome://tracing or
+https://ui.perfetto.dev
+
+Usage   python tools/trace2chrome.py monitor.log [--mhz 240] [-o trace.json]
+
+The input may be a complete monitor log, only the lines between
+'# trace ...' and '# end' of the last dump are used. The 32 bit cycle
+counter is unwrapped and converted to µs with the cycle frequency given
+in the header or with --mhz. End events whose begin was overwritten in
+the ring are dropped.
+"""
+import argparse
+import json
+import re
+import sys
+
+
+def read_dump(lines):
+    """Return (mhz, names, events) of the last dump found in lines"""
+    dump = None
+    result = None
+    for line in lines:
+        line = line.strip()
+        m = re.match(r"# trace mhz=(\d+) events=(\d+)", line)
+        if m:
+            dump = (int(m.group(1)), {}, [])
+        elif dump is None:
+            continue
+        elif line.startswith("# name "):
+            _, _, tid, name = line.split(maxsplit=3)
+            dump[1][int(tid)] = name
+        elif line == "# end":
+            result, dump = dump, None
+        elif re.match(r"\d+ \d+ [BE]$", line):
+            cycles, tid, phase = line.split()
+            dump[2].append((int(cycles), int(tid), phase))
+    if result is None:
+        sys.exit("no complete trace dump found")
+    return result
+
+
+def convert(mhz, names, events):
+    trace = []
+    depth = {}
+    t64 = 0
+    last = None
+    for cycles, tid, phase in events:
+        if last is not None:
+            t64 += (cycles - last) & 0xFFFFFFFF
+        last = cycles
+        if phase == "E":
+            if depth.get(tid, 0) == 0:
+                continue
+            depth[tid] -= 1
+        else:
+            depth[tid] = depth.get(tid, 0) + 1
+        trace.append({
+            "name": names.get(tid, str(tid)),
+            "ph": phase,
+            "ts": t64 / mhz,
+            "pid": 0,
+            "tid": 0,
+        })
+    return {"traceEvents": trace, "displayTimeUnit": "ns"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("dump", help="file with the output of the trace dump")
+    parser.add_argument("--mhz", type=float, help="cycle frequency, overrides the header")
+    parser.add_argument("-o", "--output", help="output file, default stdout")
+    args = parser.parse_args()
+
+    with open(args.dump, encoding="utf-8", errors="replace") as f:
+        mhz, names, events = read_dump(f)
+    mhz = args.mhz or mhz
+    if not mhz:
+        sys.exit("cycle frequency unknown, pass --mhz")
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    json.dump(convert(mhz, names, events), out, indent=1)
+    out.write("\n")
+
+
+if __name__ == "__main__":
+    main()